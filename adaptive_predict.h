@@ -0,0 +1,221 @@
+﻿// 自适应预测（ALL(*) 式）：LL(1) 分析表中有冲突的表项留到分析时再决定
+//
+// M[X,a] 有多个产生式的表项称为决策点。预测时从各候选产生式出发，对其后的记号逐个模拟推导
+// （配置 = 候选产生式 + 尚待匹配的符号栈），直到只剩一个候选仍然可行为止。
+//   SLL 模拟  不看分析栈：X 的右部匹配完之后只要求下一个记号属于 Follow(X)，此后接受任何记号。
+//             结论只取决于向前看的记号，记入该决策点的向前看 DFA（状态为配置集合，边为终结符），
+//             以后遇到同样的向前看直接沿 DFA 走到结论，不再模拟。
+//   LL 模拟   SLL 区分不了时（不同候选都已匹配完 X 的右部），用实际的分析栈继续模拟，结论不缓存。
+// 输入结束时仍有多个候选（文法有二义性）取下标最小的产生式；没有可行的候选时预测失败。
+// 模拟中的非终结符同样按分析表展开（遇到冲突表项则分叉），要求文法没有左递归。
+// DFA 由所有分析共享，用互斥量保护；没有冲突的表项不经过这里，仍是一次查表。
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "grammar.h"
+#include "first_follow.h"
+using namespace std;
+
+// 模拟中的一个配置。SLL 模拟中 depth 为 0，或为 kAnyInput 表示已越过 X 的后继、接受任何记号；
+// LL 模拟中 depth 为分析栈中尚未取用的符号数（栈顶的 X 不算）
+struct AdaptiveConfig {
+    int alt;             // 候选产生式的下标
+    int depth;
+    vector<int> stack;   // 待匹配的符号，栈顶在末尾
+
+    bool operator<(const AdaptiveConfig& o) const {
+        if (alt != o.alt) return alt < o.alt;
+        if (depth != o.depth) return depth < o.depth;
+        return stack < o.stack;
+    }
+    bool operator==(const AdaptiveConfig& o) const {
+        return alt == o.alt && depth == o.depth && stack == o.stack;
+    }
+};
+
+class AdaptivePredictor {
+public:
+    static constexpr int kAnyInput = -1;
+    // 配置集合的结论（非负时为预测的产生式下标）
+    static constexpr int kNoViableAlt = -1;
+    static constexpr int kUndecided = -2;
+    static constexpr int kNeedContext = -3;
+
+    // 重新绑定文法与稠密预测表（见 LL1Parser::buildPredictTable），清空所有决策点
+    void reset(const Grammar& g, const FirstFollow& s, const vector<int16_t>& t) {
+        G = &g;
+        sets = &s;
+        table = &t;
+        decisions.clear();
+        predictions = fullContext = 0;
+    }
+
+    // 增加一个决策点：M[X,a] 的候选产生式下标，返回决策点编号（预测表中记为 -2 - 编号）
+    int addDecision(int X, const vector<int>& alts) {
+        decisions.emplace_back();
+        decisions.back().X = X;
+        decisions.back().alts = alts;
+        return (int)decisions.size() - 1;
+    }
+
+    size_t size() const { return decisions.size(); }
+
+    // 决策点 d 的预测。parseStack 为当前分析栈（栈顶是 X），la(i) 为当前记号之后的第 i 个记号（la(0) 即当前记号）
+    template <typename LA>
+    int predict(int d, const vector<int>& parseStack, LA la) {
+        lock_guard<mutex> lock(mtx);
+        ++predictions;
+        LookaheadDfa& dfa = decisions[d];
+        if (dfa.states.empty()) addState(dfa, startConfigs(dfa, 0));
+        int s = 0;
+        for (size_t i = 0; ; ++i) {
+            int t = la(i);
+            int col = t < 0 ? G->numTerminals : t; // 未知记号共用最后一列
+            int next = dfa.states[s].edges[col];
+            if (next < 0) {
+                vector<AdaptiveConfig> configs = dfa.states[s].configs;
+                step(dfa.X, configs, t, nullptr);
+                next = addState(dfa, move(configs));
+                dfa.states[s].edges[col] = next;
+            }
+            s = next;
+            int v = dfa.states[s].verdict;
+            if (v == kNeedContext) return predictWithContext(dfa, parseStack, la);
+            if (v != kUndecided) return v;
+        }
+    }
+
+    // 统计（见 LL1Parser::reportProfile）
+    size_t predictionCount() const { return predictions; }
+    size_t fullContextCount() const { return fullContext; }
+    size_t dfaStates() const {
+        size_t n = 0;
+        for (auto& dfa : decisions) n += dfa.states.size();
+        return n;
+    }
+
+private:
+    struct DfaState {
+        vector<AdaptiveConfig> configs;
+        int verdict;
+        vector<int> edges; // 终结符（及未知记号）-> 状态，-1 表示尚未计算
+    };
+
+    struct LookaheadDfa {
+        int X;
+        vector<int> alts;
+        vector<DfaState> states;
+        map<vector<AdaptiveConfig>, int> index;
+    };
+
+    const Grammar* G = nullptr;
+    const FirstFollow* sets = nullptr;
+    const vector<int16_t>* table = nullptr;
+    vector<LookaheadDfa> decisions;
+    mutex mtx;
+    size_t predictions = 0, fullContext = 0;
+
+    int cell(int X, int t) const {
+        if (t < 0) return -1;
+        return (*table)[(size_t)(X - G->numTerminals) * G->numTerminals + t];
+    }
+
+    static void pushReversed(vector<int>& stack, const Grammar& g, int p) {
+        for (const int* s = g.rhsEnd(p); s != g.rhsBegin(p); ) stack.push_back(*--s);
+    }
+
+    vector<AdaptiveConfig> startConfigs(const LookaheadDfa& dfa, int depth) const {
+        vector<AdaptiveConfig> configs;
+        for (int p : dfa.alts) {
+            configs.push_back(AdaptiveConfig{ p, depth, {} });
+            pushReversed(configs.back().stack, *G, p);
+        }
+        return configs;
+    }
+
+    // 所有配置越过记号 t：展开栈顶的非终结符直到栈顶为终结符，再与 t 匹配，匹配不上的配置丢弃。
+    // context 为空时做 SLL 模拟，否则 context 为实际的分析栈
+    void step(int X, vector<AdaptiveConfig>& configs, int t, const vector<int>* context) const {
+        vector<AdaptiveConfig> work;
+        work.swap(configs);
+        while (!work.empty()) {
+            AdaptiveConfig c = move(work.back());
+            work.pop_back();
+            while (true) {
+                if (c.stack.empty()) {
+                    if (context != nullptr) {
+                        if (c.depth == 0) break; // 栈底的 $ 已匹配
+                        c.stack.push_back((*context)[--c.depth]);
+                        continue;
+                    }
+                    if (c.depth == kAnyInput || (t >= 0 && sets->follow[X - G->numTerminals].test(t))) {
+                        c.depth = kAnyInput;
+                        configs.push_back(move(c));
+                    }
+                    break;
+                }
+                int Y = c.stack.back();
+                if (G->isTerminal(Y)) {
+                    if (Y == t) {
+                        c.stack.pop_back();
+                        configs.push_back(move(c));
+                    }
+                    break;
+                }
+                int v = cell(Y, t);
+                if (v == -1) break;
+                c.stack.pop_back();
+                if (v >= 0) {
+                    pushReversed(c.stack, *G, v);
+                    continue;
+                }
+                for (int p : decisions[-2 - v].alts) {
+                    work.push_back(c);
+                    pushReversed(work.back().stack, *G, p);
+                }
+                break;
+            }
+        }
+        sort(configs.begin(), configs.end());
+        configs.erase(unique(configs.begin(), configs.end()), configs.end());
+    }
+
+    // SLL 配置集合的结论：只剩一个候选时为该候选；已接受任何记号的配置属于不同候选时需要 LL 模拟
+    int sllVerdict(const vector<AdaptiveConfig>& configs) const {
+        if (configs.empty()) return kNoViableAlt;
+        if (configs.front().alt == configs.back().alt) return configs.front().alt;
+        int any = -1;
+        for (auto& c : configs) {
+            if (c.depth != kAnyInput) continue;
+            if (any >= 0 && any != c.alt) return kNeedContext;
+            any = c.alt;
+        }
+        return kUndecided;
+    }
+
+    int addState(LookaheadDfa& dfa, vector<AdaptiveConfig> configs) {
+        auto it = dfa.index.find(configs);
+        if (it != dfa.index.end()) return it->second;
+        int s = (int)dfa.states.size();
+        int verdict = s == 0 ? kUndecided : sllVerdict(configs);
+        dfa.index.emplace(configs, s);
+        dfa.states.push_back(DfaState{ move(configs), verdict, vector<int>(G->numTerminals + 1, -1) });
+        return s;
+    }
+
+    template <typename LA>
+    int predictWithContext(const LookaheadDfa& dfa, const vector<int>& parseStack, LA la) {
+        ++fullContext;
+        vector<AdaptiveConfig> configs = startConfigs(dfa, (int)parseStack.size() - 1);
+        for (size_t i = 0; ; ++i) {
+            int t = la(i);
+            step(dfa.X, configs, t, &parseStack);
+            if (configs.empty()) return kNoViableAlt;
+            if (configs.front().alt == configs.back().alt || t == G->endMarker) return configs.front().alt;
+        }
+    }
+};
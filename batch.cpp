@@ -0,0 +1,129 @@
+﻿// 批量分析：分析表只构造一次，多个线程共享，同时分析大量输入
+//
+// 编译：g++ -O2 -std=c++17 -pthread batch.cpp -o batch
+// 用法：batch [--ll|--lr] [--threads N] [--trace] 文法文件 [输入文件]
+//
+// 文法文件采用仓库的文法格式（不含待分析的输入串）；输入文件每行一个待分析的串，
+// 按终结符最长匹配分词（见 tokenizer.h），省略时从标准输入读。
+// 输入按块读入，块内分成若干段交给线程池，各线程只读共享的分析表与分词器，
+// 分析栈各自独立；一块分析完后按输入顺序输出，每行一个结果：
+//   <行号>\taccept|reject[\t<产生式编号序列>]
+// --trace 时附上分析所用的产生式编号（LL 为推导顺序，LR 为归约顺序）。
+// 汇总（输入数、接受数、耗时与吞吐量）写到标准错误。
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ll1_parser.h"
+#include "lr1_parser.h"
+#include "thread_pool.h"
+#include "tokenizer.h"
+using namespace std;
+
+const size_t kBatchBlock = 16384;  // 每次读入的行数
+const size_t kBatchSlice = 256;    // 每个任务分析的行数
+
+struct BatchResult {
+    bool accepted;
+    vector<int> trace;
+};
+
+template <typename Parser>
+static int runBatch(Parser& parser, const string& grammarPath, istream& inputs, unsigned threads, bool trace) {
+    ifstream grammarFile(grammarPath);
+    if (!grammarFile) {
+        cerr << "Cannot open grammar file " << grammarPath << endl;
+        return 2;
+    }
+    parser.loadGrammar(grammarFile, cerr);
+    parser.buildTables();
+    const Parser& shared = parser;
+    Tokenizer lexer;
+    lexer.build(parser.grammar());
+
+    ThreadPool pool(threads);
+    vector<string> lines;
+    vector<BatchResult> results;
+    size_t total = 0, accepted = 0;
+    auto start = chrono::steady_clock::now();
+    string out;
+    while (inputs) {
+        lines.clear();
+        string line;
+        while (lines.size() < kBatchBlock && getline(inputs, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lines.push_back(move(line));
+        }
+        if (lines.empty()) break;
+
+        results.assign(lines.size(), BatchResult());
+        for (size_t b = 0; b < lines.size(); b += kBatchSlice) {
+            size_t e = min(lines.size(), b + kBatchSlice);
+            pool.submit([&, b, e]() {
+                for (size_t i = b; i < e; ++i) {
+                    results[i].accepted = shared.recognize(lexer.tokenize(lines[i]), trace ? &results[i].trace : nullptr);
+                }
+            });
+        }
+        pool.wait();
+
+        out.clear();
+        for (size_t i = 0; i < lines.size(); ++i) {
+            accepted += results[i].accepted;
+            out += to_string(total + i + 1);
+            out += results[i].accepted ? "\taccept" : "\treject";
+            if (trace) {
+                out += '\t';
+                for (size_t k = 0; k < results[i].trace.size(); ++k) {
+                    if (k) out += ' ';
+                    out += to_string(results[i].trace[k]);
+                }
+            }
+            out += '\n';
+        }
+        cout << out;
+        total += lines.size();
+    }
+    cout.flush();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << total << " inputs, " << accepted << " accepted, " << pool.size() << " threads, "
+        << seconds * 1000 << " ms, " << (seconds > 0 ? total / seconds : 0) << " inputs/s" << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    bool lr = true, trace = false;
+    unsigned threads = 0;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--ll")) lr = false;
+        else if (!strcmp(argv[i], "--lr")) lr = true;
+        else if (!strcmp(argv[i], "--trace")) trace = true;
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = (unsigned)atoi(argv[++i]);
+        else files.push_back(argv[i]);
+    }
+    if (files.empty() || files.size() > 2) {
+        cerr << "Usage: batch [--ll|--lr] [--threads N] [--trace] GRAMMAR [INPUTS]" << endl;
+        return 2;
+    }
+    ifstream inputFile;
+    if (files.size() == 2) {
+        inputFile.open(files[1]);
+        if (!inputFile) {
+            cerr << "Cannot open input file " << files[1] << endl;
+            return 2;
+        }
+    }
+    istream& inputs = files.size() == 2 ? inputFile : cin;
+    ios::sync_with_stdio(false);
+    if (lr) {
+        LR1Parser parser;
+        return runBatch(parser, files[0], inputs, threads, trace);
+    }
+    LL1Parser parser;
+    return runBatch(parser, files[0], inputs, threads, trace);
+}
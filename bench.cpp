@@ -0,0 +1,162 @@
+﻿// 分析程序基准测试
+//
+// 编译：g++ -O2 -std=c++17 -pthread bench.cpp -o bench
+// 用法：bench [--family tower|wide|list|c] [--size N] [--tokens T] [--length L] [--seed S]
+// 不指定 --family 时运行默认的一组文法与规模。
+//
+// 对每个文法分别用 LL1Parser 与 LR1Parser：
+//   记录建表时间（First / Follow、项目集规范族与分析表）、状态数（LL 为分析表行数）与表项数；
+//   用同一种子生成总长约 T 个记号、每句约 L 个记号的合法句子，以及各改动一个记号的近似合法句子，
+//   测量不输出分析过程时的吞吐量（记号/秒）与接受的句子数。
+// 每行输出一条结果，字段以制表符分隔。
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_gen.h"
+#include "ll1_parser.h"
+#include "lr1_parser.h"
+using namespace std;
+
+struct BenchOptions {
+    size_t tokens = 200000;
+    size_t length = 1000;
+    uint64_t seed = 1;
+};
+
+struct Corpus {
+    vector<vector<int>> valid;
+    vector<vector<int>> nearValid;
+    size_t validTokens = 0;
+    size_t nearTokens = 0;
+};
+
+static double secondsSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+// 把 from 文法中的终结符编号按名字换成 to 文法中的编号（两个分析程序化简后的编号可能不同）
+static vector<vector<int>> translate(const vector<vector<int>>& in, const Grammar& from, const Grammar& to) {
+    vector<int> map(from.numTerminals);
+    for (int t = 0; t < from.numTerminals; ++t) map[t] = to.lookup(from.names[t]);
+    vector<vector<int>> out(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        out[i].reserve(in[i].size());
+        for (int t : in[i]) out[i].push_back(map[t]);
+    }
+    return out;
+}
+
+// 在 LL 形式的文法上生成句子（语言与 LR 形式相同）
+static Corpus makeCorpus(const Grammar& g, const BenchOptions& opt) {
+    Corpus c;
+    SentenceGenerator gen(g, opt.seed);
+    while (c.validTokens < opt.tokens) {
+        vector<int> s = gen.sentence(opt.length);
+        c.validTokens += s.size() + 1;
+        c.nearValid.push_back(gen.mutate(s));
+        c.nearTokens += c.nearValid.back().size() + 1;
+        c.valid.push_back(move(s));
+    }
+    return c;
+}
+
+// 分析全部句子，返回 (秒, 接受数)
+template <typename Parser>
+static pair<double, size_t> parseAll(Parser& parser, const vector<vector<int>>& sentences) {
+    size_t accepted = 0;
+    auto t = chrono::steady_clock::now();
+    for (auto& s : sentences) accepted += parser.recognize(s);
+    return make_pair(secondsSince(t), accepted);
+}
+
+static void report(const string& family, int size, const char* engine, double buildMs, int states,
+    size_t entries, const Corpus& c, pair<double, size_t> valid, pair<double, size_t> nearValid) {
+    cout << family << "\t" << size << "\t" << engine << "\t" << fixed << setprecision(3) << buildMs << "\t"
+        << states << "\t" << entries << "\t"
+        << setprecision(0) << c.validTokens / max(valid.first, 1e-9) << "\t" << valid.second << "/" << c.valid.size() << "\t"
+        << c.nearTokens / max(nearValid.first, 1e-9) << "\t" << nearValid.second << "/" << c.nearValid.size() << "\n";
+}
+
+static void runBench(const string& family, int size, const string& text, const BenchOptions& opt) {
+    ostringstream log; // 化简报告不输出
+
+    LL1Parser ll;
+    {
+        istringstream in(text);
+        ll.loadGrammar(in, log);
+    }
+    auto t = chrono::steady_clock::now();
+    ll.buildTables();
+    double llBuild = secondsSince(t) * 1000;
+
+    LR1Parser lr;
+    {
+        istringstream in(text);
+        lr.loadGrammar(in, log);
+    }
+    t = chrono::steady_clock::now();
+    lr.buildTables();
+    double lrBuild = secondsSince(t) * 1000;
+
+    Corpus c = makeCorpus(ll.grammar(), opt);
+    report(family, size, "ll1", llBuild, ll.grammar().numNonTerminals(), ll.tableEntries(), c,
+        parseAll(ll, c.valid), parseAll(ll, c.nearValid));
+
+    Corpus lc;
+    lc.valid = translate(c.valid, ll.grammar(), lr.grammar());
+    lc.nearValid = translate(c.nearValid, ll.grammar(), lr.grammar());
+    lc.validTokens = c.validTokens;
+    lc.nearTokens = c.nearTokens;
+    report(family, size, "lr1", lrBuild, lr.numStates(), lr.tableEntries(), lc,
+        parseAll(lr, lc.valid), parseAll(lr, lc.nearValid));
+}
+
+static string familyText(const string& family, int size) {
+    string text = familyGrammar(family, size);
+    if (text.empty()) {
+        cerr << "Unknown grammar family: " << family << endl;
+        exit(1);
+    }
+    return text;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    string family;
+    int size = 0;
+    for (int i = 1; i < argc; ++i) {
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                cerr << "Missing value for " << argv[i] << endl;
+                exit(1);
+            }
+            return argv[++i];
+        };
+        if (!strcmp(argv[i], "--family")) family = value();
+        else if (!strcmp(argv[i], "--size")) size = atoi(value());
+        else if (!strcmp(argv[i], "--tokens")) opt.tokens = strtoull(value(), nullptr, 10);
+        else if (!strcmp(argv[i], "--length")) opt.length = strtoull(value(), nullptr, 10);
+        else if (!strcmp(argv[i], "--seed")) opt.seed = strtoull(value(), nullptr, 10);
+        else {
+            cerr << "Usage: bench [--family tower|wide|list|c] [--size N] [--tokens T] [--length L] [--seed S]" << endl;
+            return 1;
+        }
+    }
+
+    cout << "family\tsize\tengine\tbuild_ms\tstates\tentries\tvalid_tok_s\tvalid_accepted\tnear_tok_s\tnear_accepted\n";
+    if (!family.empty()) {
+        if (size <= 0) size = family == "c" ? 1 : 8;
+        runBench(family, size, familyText(family, size), opt);
+        return 0;
+    }
+    for (int n : { 4, 8, 16 }) runBench("tower", n, precedenceTower(n), opt);
+    for (int n : { 16, 32, 64 }) runBench("wide", n, wideAlternation(n), opt);
+    for (int n : { 2, 4, 8 }) runBench("list", n, listGrammar(n), opt);
+    runBench("c", 1, cSubset(), opt);
+    return 0;
+}
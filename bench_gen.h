@@ -0,0 +1,179 @@
+﻿// 基准测试用的文法族与句子生成器
+//
+// 文法族都按规模参数 N 生成，采用仓库的文法文本格式（见 Grammar::read），
+// 同时是 LL(1) 与 LR(1) 文法。运算符等终结符用单词命名，以免与 EBNF 元符号冲突。
+//   precedenceTower(N)  N 层优先级的表达式：S -> E0，Ei -> Ei+1 ( oi Ei+1 )*
+//   wideAlternation(N)  N 个关键字开头的候选式：S -> X*，X -> k0 id | k1 id | …
+//   listGrammar(N)      N 层嵌套的带分隔符列表：Li -> lb ( Li+1 ( si Li+1 )* )? rb
+//   cSubset()           C 语言子集：声明、函数、语句块、if/while/return 与表达式
+// SentenceGenerator 从任意文法随机推导出给定长度附近的句子，并能把句子随机改动一个记号，
+// 得到“接近合法”的输入。
+#pragma once
+
+#include <climits>
+#include <random>
+#include <string>
+#include <vector>
+#include "grammar.h"
+using namespace std;
+
+// 按仓库格式拼出文法文本（不含待分析的输入串）
+inline string grammarText(const string& start, const vector<string>& nonterminals,
+    const vector<string>& terminals, const vector<string>& productions) {
+    string s = start + "\n";
+    for (auto& x : nonterminals) s += x + " ";
+    s += "\n";
+    for (auto& x : terminals) s += x + " ";
+    s += "\n" + to_string(productions.size()) + "\n";
+    for (auto& p : productions) s += p + "\n";
+    return s;
+}
+
+inline string precedenceTower(int N) {
+    // E0 出现在括号中，LR1Parser 把第一个产生式当作拓广产生式，因此先加 S -> E0
+    vector<string> nts = { "S" }, ts, prods = { "S -> E0" };
+    for (int i = 0; i <= N; ++i) nts.push_back("E" + to_string(i));
+    for (int i = 0; i < N; ++i) {
+        ts.push_back("o" + to_string(i));
+        string next = "E" + to_string(i + 1);
+        prods.push_back("E" + to_string(i) + " -> " + next + " ( o" + to_string(i) + " " + next + " )*");
+    }
+    ts.insert(ts.end(), { "lp", "rp", "id" });
+    prods.push_back("E" + to_string(N) + " -> lp E0 rp | id");
+    return grammarText("S", nts, ts, prods);
+}
+
+inline string wideAlternation(int N) {
+    vector<string> ts;
+    string alts;
+    for (int i = 0; i < N; ++i) {
+        ts.push_back("k" + to_string(i));
+        alts += (i ? " | k" : "k") + to_string(i) + " id";
+    }
+    ts.push_back("id");
+    return grammarText("S", { "S", "X" }, ts, { "S -> X*", "X -> " + alts });
+}
+
+inline string listGrammar(int N) {
+    vector<string> nts, ts = { "lb", "rb", "id" }, prods;
+    for (int i = 0; i < N; ++i) {
+        nts.push_back("L" + to_string(i));
+        ts.push_back("s" + to_string(i));
+        string item = i + 1 < N ? "L" + to_string(i + 1) : "id";
+        string sep = "s" + to_string(i);
+        prods.push_back("L" + to_string(i) + " -> lb ( " + item + " ( " + sep + " " + item + " )* )? rb");
+    }
+    return grammarText("L0", nts, ts, prods);
+}
+
+inline string cSubset() {
+    return grammarText("program",
+        { "program", "decl", "declTail", "type", "params", "param", "block", "stmt", "expr",
+          "rel", "relop", "add", "addop", "mul", "mulop", "unary", "postfix", "primary", "args" },
+        { "int", "char", "void", "id", "num", "lp", "rp", "lb", "rb", "semi", "comma", "assign",
+          "if", "else", "while", "return", "lt", "gt", "eqeq", "ne", "plus", "minus", "star", "slash", "not" },
+        { "program -> decl*",
+          "decl -> type id declTail",
+          "declTail -> semi | assign expr semi | lp params rp block",
+          "type -> int | char | void",
+          "params -> param ( comma param )* | e",
+          "param -> type id",
+          "block -> lb stmt* rb",
+          "stmt -> block | if lp expr rp block ( else block )? | while lp expr rp stmt | return expr? semi | type id ( assign expr )? semi | expr semi",
+          "expr -> rel ( assign rel )?",
+          "rel -> add ( relop add )*",
+          "relop -> lt | gt | eqeq | ne",
+          "add -> mul ( addop mul )*",
+          "addop -> plus | minus",
+          "mul -> unary ( mulop unary )*",
+          "mulop -> star | slash",
+          "unary -> minus unary | not unary | postfix",
+          "postfix -> primary ( lp args rp )?",
+          "primary -> id | num | lp expr rp",
+          "args -> expr ( comma expr )* | e" });
+}
+
+// 按族名与规模生成文法文本，族名未知时返回空串
+inline string familyGrammar(const string& family, int size) {
+    if (family == "tower") return precedenceTower(size);
+    if (family == "wide") return wideAlternation(size);
+    if (family == "list") return listGrammar(size);
+    if (family == "c") return cSubset();
+    return "";
+}
+
+// 随机句子生成：自左向右推导，剩余长度预算不足时改选最短推导的候选式
+class SentenceGenerator {
+public:
+    SentenceGenerator(const Grammar& g, uint64_t seed) : G(g), rng(seed) {
+        // 每个符号能推出的最短终结符串长度（不动点）及对应的候选式
+        minLen.assign(G.numSymbols(), INT_MAX / 2);
+        minProd.assign(G.numSymbols(), -1);
+        for (int t = 0; t < G.numTerminals; ++t) minLen[t] = t == G.epsilon ? 0 : 1;
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (int p = 0; p < G.numProductions(); ++p) {
+                int len = rhsMinLen(p), A = G.prodLhs[p];
+                if (len < minLen[A]) {
+                    minLen[A] = len;
+                    minProd[A] = p;
+                    changed = true;
+                }
+            }
+        }
+        for (int t = 0; t < G.numTerminals; ++t) {
+            if (t != G.epsilon && t != G.endMarker) terminals.push_back(t);
+        }
+    }
+
+    // 推导一个长度约为 target 的句子（终结符编号序列）
+    vector<int> sentence(size_t target) {
+        vector<int> out, stack(1, G.startSymbol);
+        long pending = minLen[G.startSymbol]; // 栈中符号最短推导长度之和
+        while (!stack.empty()) {
+            int X = stack.back();
+            stack.pop_back();
+            pending -= minLen[X];
+            if (G.isTerminal(X)) {
+                out.push_back(X);
+                continue;
+            }
+            // 循环符号（EBNF 重复）以 15/16 的概率继续，使列表足够长；其余候选式等概率
+            int count = int(G.altsEnd(X) - G.altsBegin(X));
+            int p = G.altsBegin(X)[rng() % count];
+            if (G.isLoop(X) && rng() % 16 != 0) {
+                for (const int* q = G.altsBegin(X); q != G.altsEnd(X); ++q) {
+                    if (G.rhsLength(*q) > 0) p = *q;
+                }
+            }
+            if ((long)out.size() + pending + rhsMinLen(p) > (long)target) p = minProd[X];
+            for (const int* s = G.rhsEnd(p); s != G.rhsBegin(p); ) {
+                stack.push_back(*--s);
+                pending += minLen[*s];
+            }
+        }
+        return out;
+    }
+
+    // 随机删除、插入或替换一个记号
+    vector<int> mutate(vector<int> s) {
+        int op = rng() % 3;
+        size_t i = s.empty() ? 0 : rng() % s.size();
+        int t = terminals[rng() % terminals.size()];
+        if (op == 0 && !s.empty()) s.erase(s.begin() + i);
+        else if (op == 1 || s.empty()) s.insert(s.begin() + i, t);
+        else s[i] = t;
+        return s;
+    }
+
+private:
+    const Grammar& G;
+    mt19937_64 rng;
+    vector<int> minLen, minProd, terminals;
+
+    int rhsMinLen(int p) const {
+        long len = 0;
+        for (const int* s = G.rhsBegin(p); s != G.rhsEnd(p); ++s) len += minLen[*s];
+        return (int)min<long>(len, INT_MAX / 2);
+    }
+};
@@ -0,0 +1,642 @@
+﻿// First / Follow 集合计算（LL1Parser 与 LR1Parser 共用）
+//
+// 集合用按终结符编号的稠密位集表示，并集是逐字（64 位）的按位或，
+// 循环写成无分支的形式，编译器可自动向量化；是否变化通过比较字得到。
+//
+// 不再对全部产生式做不动点迭代：先用工作表求出可空性，再把非终结符之间的
+// 依赖关系建成图，用 Tarjan 算法缩成强连通分量。同一分量内各非终结符的
+// 集合必然相等，因此每个分量按拓扑序只求一次；互不依赖的分量可在线程池上并行求解。
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "grammar.h"
+#include "thread_pool.h"
+using namespace std;
+
+// 按编号从小到大对位集 w[0 .. n) 中的每个元素调用 f
+template <typename F>
+inline void forEachBit(const uint64_t* w, size_t n, F f) {
+    for (size_t k = 0; k < n; ++k) {
+        uint64_t x = w[k];
+        while (x) {
+            f(int(k * 64 + __builtin_ctzll(x)));
+            x &= x - 1;
+        }
+    }
+}
+
+// 只读位集视图，指向扁平数组中的一行
+struct TermSetView {
+    const uint64_t* w;
+    size_t n;
+
+    bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+
+    template <typename F>
+    void forEach(F f) const { forEachBit(w, n, f); }
+};
+
+// 稠密位集
+class TermSet {
+public:
+    TermSet() {}
+    explicit TermSet(int n) : w((n + 63) / 64, 0) {}
+
+    bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { w[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(int i) { w[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    void clear() { for (auto& x : w) x = 0; }
+
+    // this |= o，返回是否有新元素加入
+    bool unionWith(TermSetView o) {
+        uint64_t* a = w.data();
+        const uint64_t* b = o.w;
+        size_t n = w.size();
+        uint64_t diff = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t v = a[i] | b[i];
+            diff |= v ^ a[i];
+            a[i] = v;
+        }
+        return diff != 0;
+    }
+    bool unionWith(const TermSet& o) { return unionWith(o.view()); }
+
+    bool operator==(const TermSet& o) const { return w == o.w; }
+    bool operator!=(const TermSet& o) const { return w != o.w; }
+
+    bool empty() const {
+        for (auto x : w) if (x) return false;
+        return true;
+    }
+
+    TermSetView view() const { return TermSetView{ w.data(), w.size() }; }
+    size_t words() const { return w.size(); }
+    const uint64_t* data() const { return w.data(); }
+
+    // 按编号从小到大对每个元素调用 f
+    template <typename F>
+    void forEach(F f) const { forEachBit(w.data(), w.size(), f); }
+
+private:
+    vector<uint64_t> w;
+};
+
+// 依赖图（CSR 存储）：结点 v 依赖 target[offset[v] .. offset[v+1])
+struct DepGraph {
+    vector<int> offset;
+    vector<int> target;
+
+    // 由边表 (from, to) 构造，去掉自环与重边
+    void build(int n, vector<pair<int, int>>& edges) {
+        sort(edges.begin(), edges.end());
+        edges.erase(unique(edges.begin(), edges.end()), edges.end());
+        offset.assign(n + 1, 0);
+        target.clear();
+        for (auto& e : edges) {
+            if (e.first == e.second) continue;
+            offset[e.first + 1]++;
+            target.push_back(e.second);
+        }
+        for (int v = 0; v < n; ++v) offset[v + 1] += offset[v];
+    }
+
+    int size() const { return (int)offset.size() - 1; }
+};
+
+// Tarjan 强连通分量（非递归实现）。comp[v] 为 v 所在分量编号；
+// 分量按完成顺序编号，被依赖的分量编号总是更小，即编号顺序就是求解顺序。返回分量数。
+inline int tarjanScc(const DepGraph& g, vector<int>& comp) {
+    int n = g.size();
+    vector<int> index(n, -1), low(n, 0), edgePos(n, 0), stk, callStack;
+    vector<char> onStack(n, 0);
+    comp.assign(n, -1);
+    int counter = 0, numComps = 0;
+    for (int root = 0; root < n; ++root) {
+        if (index[root] != -1) continue;
+        callStack.push_back(root);
+        index[root] = low[root] = counter++;
+        edgePos[root] = g.offset[root];
+        stk.push_back(root);
+        onStack[root] = 1;
+        while (!callStack.empty()) {
+            int v = callStack.back();
+            if (edgePos[v] < g.offset[v + 1]) {
+                int w = g.target[edgePos[v]++];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    edgePos[w] = g.offset[w];
+                    stk.push_back(w);
+                    onStack[w] = 1;
+                    callStack.push_back(w);
+                }
+                else if (onStack[w]) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+            // v 的所有后继已处理完
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                int u = callStack.back();
+                low[u] = min(low[u], low[v]);
+            }
+            if (low[v] == index[v]) {
+                int w;
+                do {
+                    w = stk.back();
+                    stk.pop_back();
+                    onStack[w] = 0;
+                    comp[w] = numComps;
+                } while (w != v);
+                numComps++;
+            }
+        }
+    }
+    return numComps;
+}
+
+// 在依赖图上求解 sets[v] = direct[v] ∪ (v 所依赖结点的 sets)。
+// 调用时 sets 中存放 direct，返回时为最终结果。
+// 每个强连通分量求一次：分量集合 = 成员 direct 之并 ∪ 所依赖分量的集合。
+// threads > 1 时按依赖计数调度，依赖都已求出的分量立即提交到线程池。
+inline void solveBySccs(const DepGraph& g, vector<TermSet>& sets, int threads) {
+    int n = g.size();
+    if (n == 0) return;
+    vector<int> comp;
+    int K = tarjanScc(g, comp);
+
+    // 分量成员（CSR）
+    vector<int> memberOffset(K + 1, 0), members(n);
+    for (int v = 0; v < n; ++v) memberOffset[comp[v] + 1]++;
+    for (int c = 0; c < K; ++c) memberOffset[c + 1] += memberOffset[c];
+    {
+        vector<int> fill(memberOffset.begin(), memberOffset.end() - 1);
+        for (int v = 0; v < n; ++v) members[fill[comp[v]]++] = v;
+    }
+
+    // 分量之间的依赖
+    vector<pair<int, int>> compEdges;
+    for (int v = 0; v < n; ++v) {
+        for (int k = g.offset[v]; k < g.offset[v + 1]; ++k) {
+            int cw = comp[g.target[k]];
+            if (cw != comp[v]) compEdges.emplace_back(comp[v], cw);
+        }
+    }
+    DepGraph cg;
+    cg.build(K, compEdges);
+
+    // 求解一个分量：依赖的分量已经求出，其结果存放在任一成员的 sets 中
+    auto solve = [&](int c) {
+        int head = members[memberOffset[c]];
+        TermSet& acc = sets[head];
+        for (int k = memberOffset[c] + 1; k < memberOffset[c + 1]; ++k) {
+            acc.unionWith(sets[members[k]]);
+        }
+        for (int k = cg.offset[c]; k < cg.offset[c + 1]; ++k) {
+            acc.unionWith(sets[members[memberOffset[cg.target[k]]]]);
+        }
+        for (int k = memberOffset[c] + 1; k < memberOffset[c + 1]; ++k) {
+            sets[members[k]] = acc;
+        }
+    };
+
+    if (threads <= 1 || K < 2) {
+        // 分量编号顺序即拓扑序
+        for (int c = 0; c < K; ++c) solve(c);
+        return;
+    }
+
+    // 并行：记录每个分量尚未求出的依赖数，以及反向边（谁依赖它）
+    vector<int> revOffset(K + 1, 0), rev(cg.target.size());
+    for (int t : cg.target) revOffset[t + 1]++;
+    for (int c = 0; c < K; ++c) revOffset[c + 1] += revOffset[c];
+    {
+        vector<int> fill(revOffset.begin(), revOffset.end() - 1);
+        for (int c = 0; c < K; ++c) {
+            for (int k = cg.offset[c]; k < cg.offset[c + 1]; ++k) rev[fill[cg.target[k]]++] = c;
+        }
+    }
+    unique_ptr<atomic<int>[]> remaining(new atomic<int>[K]);
+    for (int c = 0; c < K; ++c) remaining[c] = cg.offset[c + 1] - cg.offset[c];
+
+    ThreadPool pool(threads);
+    function<void(int)> run = [&](int c) {
+        solve(c);
+        for (int k = revOffset[c]; k < revOffset[c + 1]; ++k) {
+            int d = rev[k];
+            if (--remaining[d] == 0) pool.submit([&run, d] { run(d); });
+        }
+    };
+    for (int c = 0; c < K; ++c) {
+        if (remaining[c] == 0) pool.submit([&run, c] { run(c); });
+    }
+    pool.wait();
+}
+
+// FirstFollow::update 的结果：哪些集合真正发生了变化
+struct FirstFollowDelta {
+    vector<char> firstChanged;          // First 或可空性有变化，下标为 (符号编号 - numTerminals)
+    vector<char> followChanged;         // Follow 有变化
+    vector<char> prodTouched;           // 后缀行被重新填写的产生式，下标为产生式下标
+};
+
+// 文法的 First / Follow / 可空信息
+// first 与 follow 只为非终结符保存，下标为 (符号编号 - numTerminals)；
+// ε 不放在 first 中，而是由 nullable 位集单独表示
+struct FirstFollow {
+    const Grammar* G = nullptr;
+    vector<TermSet> first;
+    vector<TermSet> follow;
+    TermSet nullable;
+
+    // 产生式右部每个后缀 rhs[i..] 的 First 集合与可空性，在 First 求出后一次算好。
+    // 产生式 p 占 rhsLength(p)+1 行，第 i 行对应后缀 rhs[i..]（最后一行为空串）。
+    vector<uint64_t> suffixWords;
+    vector<char> suffixNull;
+    size_t W = 0; // 每行的字数
+
+    // 求解分量时使用的线程数，0 表示自动（非终结符较多时才使用多线程）
+    int threads = 0;
+
+    bool isNullable(int X) const {
+        return G->isNonTerminal(X) && nullable.test(X - G->numTerminals);
+    }
+
+    // 计算 First 集合与可空性
+    void computeFirst(const Grammar& g) {
+        G = &g;
+        int T = g.numTerminals, N = g.numNonTerminals();
+        computeNullable();
+
+        // First(A) 直接包含的终结符，以及 A 依赖的非终结符 B（B 之前的符号都可空）
+        first.assign(N, TermSet(T));
+        vector<pair<int, int>> edges;
+        for (int p = 0; p < g.numProductions(); ++p) {
+            int A = g.prodLhs[p] - T;
+            for (const int* s = g.rhsBegin(p); s != g.rhsEnd(p); ++s) {
+                if (g.isTerminal(*s)) {
+                    first[A].set(*s);
+                    break;
+                }
+                edges.emplace_back(A, *s - T);
+                if (!nullable.test(*s - T)) break;
+            }
+        }
+        DepGraph dg;
+        dg.build(N, edges);
+        solveBySccs(dg, first, threadCount());
+
+        buildSuffixTable();
+    }
+
+    // 后缀 rhs[i..] 在表中的行号
+    int suffixSlot(int p, int i) const { return G->prodOffset[p] + p + i; }
+
+    // First(rhs[i..])（不含 ε）
+    TermSetView suffixFirst(int p, int i) const {
+        return TermSetView{ suffixWords.data() + (size_t)suffixSlot(p, i) * W, W };
+    }
+
+    // rhs[i..] 是否可空
+    bool suffixNullable(int p, int i) const { return suffixNull[suffixSlot(p, i)]; }
+
+    // 填写每个产生式的后缀表
+    void buildSuffixTable() {
+        const Grammar& g = *G;
+        W = (g.numTerminals + 63) / 64;
+        size_t rows = g.rhs.size() + g.numProductions();
+        suffixWords.assign(rows * W, 0);
+        suffixNull.assign(rows, 0);
+        for (int p = 0; p < g.numProductions(); ++p) fillSuffixRows(p);
+    }
+
+    // 自右向左填写产生式 p 的后缀行：
+    // 空串可空；X 为终结符时为 {X}；X 为非终结符时为 First(X)，X 可空再并上后一行
+    void fillSuffixRows(int p) {
+        const Grammar& g = *G;
+        int T = g.numTerminals;
+        int len = g.rhsLength(p);
+        const int* rhs = g.rhsBegin(p);
+        suffixNull[suffixSlot(p, len)] = 1;
+        uint64_t* last = suffixWords.data() + (size_t)suffixSlot(p, len) * W;
+        for (size_t k = 0; k < W; ++k) last[k] = 0;
+        for (int i = len - 1; i >= 0; --i) {
+            uint64_t* row = suffixWords.data() + (size_t)suffixSlot(p, i) * W;
+            int X = rhs[i];
+            if (g.isTerminal(X)) {
+                for (size_t k = 0; k < W; ++k) row[k] = 0;
+                row[X >> 6] |= uint64_t(1) << (X & 63);
+                suffixNull[suffixSlot(p, i)] = 0;
+                continue;
+            }
+            const uint64_t* f = first[X - T].data();
+            if (nullable.test(X - T)) {
+                const uint64_t* next = row + W;
+                for (size_t k = 0; k < W; ++k) row[k] = f[k] | next[k];
+                suffixNull[suffixSlot(p, i)] = suffixNull[suffixSlot(p, i + 1)];
+            }
+            else {
+                for (size_t k = 0; k < W; ++k) row[k] = f[k];
+                suffixNull[suffixSlot(p, i)] = 0;
+            }
+        }
+    }
+
+    // 计算 Follow 集合（须先调用 computeFirst）
+    void computeFollow() {
+        const Grammar& g = *G;
+        int T = g.numTerminals, N = g.numNonTerminals();
+        follow.assign(N, TermSet(T));
+        // 开始符号的 Follow 集加入 $
+        follow[g.startSymbol - T].set(g.endMarker);
+
+        // 对右部中的每个非终结符 B：First(beta) 直接并入 Follow(B)，beta 可空时 Follow(B) 依赖 Follow(A)
+        vector<pair<int, int>> edges;
+        for (int p = 0; p < g.numProductions(); ++p) {
+            int A = g.prodLhs[p] - T;
+            const int* rhs = g.rhsBegin(p);
+            for (int i = 0; i < g.rhsLength(p); ++i) {
+                if (!g.isNonTerminal(rhs[i])) continue;
+                int B = rhs[i] - T;
+                follow[B].unionWith(suffixFirst(p, i + 1));
+                if (suffixNullable(p, i + 1)) edges.emplace_back(B, A);
+            }
+        }
+        DepGraph dg;
+        dg.build(N, edges);
+        solveBySccs(dg, follow, threadCount());
+    }
+
+    // 求可空性：记录每个产生式右部中尚未确定可空的符号数，降为 0 时左部可空
+    void computeNullable() {
+        const Grammar& g = *G;
+        int T = g.numTerminals, N = g.numNonTerminals();
+        nullable = TermSet(N);
+
+        // occurs[B] 为右部含 B 的产生式（按出现次数重复）
+        vector<int> occOffset(N + 1, 0), occ;
+        vector<int> unknown(g.numProductions(), 0);
+        for (int p = 0; p < g.numProductions(); ++p) {
+            for (const int* s = g.rhsBegin(p); s != g.rhsEnd(p); ++s) {
+                if (g.isNonTerminal(*s)) occOffset[*s - T + 1]++;
+                unknown[p]++;
+            }
+        }
+        for (int B = 0; B < N; ++B) occOffset[B + 1] += occOffset[B];
+        occ.resize(occOffset[N]);
+        {
+            vector<int> fill(occOffset.begin(), occOffset.end() - 1);
+            for (int p = 0; p < g.numProductions(); ++p) {
+                for (const int* s = g.rhsBegin(p); s != g.rhsEnd(p); ++s) {
+                    if (g.isNonTerminal(*s)) occ[fill[*s - T]++] = p;
+                }
+            }
+        }
+
+        vector<int> work;
+        for (int p = 0; p < g.numProductions(); ++p) {
+            int A = g.prodLhs[p] - T;
+            if (unknown[p] == 0 && !nullable.test(A)) {
+                nullable.set(A);
+                work.push_back(A);
+            }
+        }
+        while (!work.empty()) {
+            int B = work.back();
+            work.pop_back();
+            for (int k = occOffset[B]; k < occOffset[B + 1]; ++k) {
+                int p = occ[k];
+                int A = g.prodLhs[p] - T;
+                if (--unknown[p] == 0 && !nullable.test(A)) {
+                    nullable.set(A);
+                    work.push_back(A);
+                }
+            }
+        }
+    }
+
+    // 产生式 p 即将被删除：去掉它在后缀表中的行（须在 Grammar::removeProduction 之前调用）
+    void eraseSuffixRows(int p) {
+        size_t b = suffixSlot(p, 0), e = suffixSlot(p, G->rhsLength(p)) + 1;
+        suffixWords.erase(suffixWords.begin() + b * W, suffixWords.begin() + e * W);
+        suffixNull.erase(suffixNull.begin() + b, suffixNull.begin() + e);
+    }
+
+    // 文法增删了产生式 A -> body 之后增量更新（added 为新增产生式的下标，删除时为 -1）。
+    // 只重新求解可能受影响的非终结符：
+    //   First / 可空：A 以及右部（传递地）含有 A 的产生式的左部；
+    //   Follow：body 与后缀行有变化的产生式中的非终结符，以及（传递地）
+    //           出现在它们产生式可空后缀之前的非终结符。
+    // 受影响集合之外的集合当作已知量，集合内部仍按依赖图的强连通分量求解。
+    FirstFollowDelta update(int A, const vector<int>& body, int added = -1) {
+        const Grammar& g = *G;
+        int T = g.numTerminals, N = g.numNonTerminals(), P = g.numProductions();
+        FirstFollowDelta d;
+        d.firstChanged.assign(N, 0);
+        d.followChanged.assign(N, 0);
+        d.prodTouched.assign(P, 0);
+
+        // 1. First 受影响的非终结符：沿“B 出现在 C 的产生式右部”反向传递
+        vector<int> affected, local(N, -1);
+        {
+            vector<pair<int, int>> edges;
+            for (int p = 0; p < P; ++p) {
+                for (const int* s = g.rhsBegin(p); s != g.rhsEnd(p); ++s) {
+                    if (g.isNonTerminal(*s)) edges.emplace_back(*s - T, g.prodLhs[p] - T);
+                }
+            }
+            DepGraph usedBy;
+            usedBy.build(N, edges);
+            local[A - T] = 0;
+            affected.push_back(A - T);
+            for (size_t k = 0; k < affected.size(); ++k) {
+                int B = affected[k];
+                for (int j = usedBy.offset[B]; j < usedBy.offset[B + 1]; ++j) {
+                    int C = usedBy.target[j];
+                    if (local[C] < 0) {
+                        local[C] = (int)affected.size();
+                        affected.push_back(C);
+                    }
+                }
+            }
+        }
+        int K = (int)affected.size();
+
+        // 2. 受影响者的可空性：集合之外的可空性不变，在集合内迭代到不动点
+        TermSet oldNullable = nullable;
+        for (int B : affected) nullable.reset(B);
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (int B : affected) {
+                if (nullable.test(B)) continue;
+                for (const int* q = g.altsBegin(B + T); q != g.altsEnd(B + T); ++q) {
+                    bool all = true;
+                    for (const int* s = g.rhsBegin(*q); all && s != g.rhsEnd(*q); ++s) {
+                        all = g.isNonTerminal(*s) && nullable.test(*s - T);
+                    }
+                    if (all) {
+                        nullable.set(B);
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // 3. 受影响者的 First：集合之外的 First 直接并入，集合之内建依赖图求解
+        {
+            vector<TermSet> sets(K, TermSet(T));
+            vector<pair<int, int>> edges;
+            for (int k = 0; k < K; ++k) {
+                int B = affected[k];
+                for (const int* q = g.altsBegin(B + T); q != g.altsEnd(B + T); ++q) {
+                    for (const int* s = g.rhsBegin(*q); s != g.rhsEnd(*q); ++s) {
+                        if (g.isTerminal(*s)) {
+                            sets[k].set(*s);
+                            break;
+                        }
+                        int C = *s - T;
+                        if (local[C] >= 0) edges.emplace_back(k, local[C]);
+                        else sets[k].unionWith(first[C]);
+                        if (!nullable.test(C)) break;
+                    }
+                }
+            }
+            DepGraph dg;
+            dg.build(K, edges);
+            solveBySccs(dg, sets, threadCount());
+            for (int k = 0; k < K; ++k) {
+                int B = affected[k];
+                if (sets[k] != first[B] || nullable.test(B) != oldNullable.test(B)) d.firstChanged[B] = 1;
+                first[B] = move(sets[k]);
+            }
+        }
+
+        // 4. 后缀表：新增产生式的行接在表尾；右部含 First 有变化的符号的产生式重新填写
+        if (added >= 0) {
+            size_t rows = g.rhs.size() + P;
+            suffixWords.resize(rows * W, 0);
+            suffixNull.resize(rows, 0);
+            d.prodTouched[added] = 1;
+        }
+        for (int p = 0; p < P; ++p) {
+            for (const int* s = g.rhsBegin(p); !d.prodTouched[p] && s != g.rhsEnd(p); ++s) {
+                if (g.isNonTerminal(*s) && d.firstChanged[*s - T]) d.prodTouched[p] = 1;
+            }
+            if (d.prodTouched[p]) fillSuffixRows(p);
+        }
+
+        // 5. Follow 受影响的非终结符
+        affected.clear();
+        local.assign(N, -1);
+        auto mark = [&](int B) {
+            if (local[B] < 0) {
+                local[B] = (int)affected.size();
+                affected.push_back(B);
+            }
+        };
+        for (int x : body) {
+            if (g.isNonTerminal(x)) mark(x - T);
+        }
+        for (int p = 0; p < P; ++p) {
+            if (!d.prodTouched[p]) continue;
+            for (const int* s = g.rhsBegin(p); s != g.rhsEnd(p); ++s) {
+                if (g.isNonTerminal(*s)) mark(*s - T);
+            }
+        }
+        for (size_t k = 0; k < affected.size(); ++k) {
+            int C = affected[k];
+            for (const int* q = g.altsBegin(C + T); q != g.altsEnd(C + T); ++q) {
+                const int* rhs = g.rhsBegin(*q);
+                for (int i = 0; i < g.rhsLength(*q); ++i) {
+                    if (g.isNonTerminal(rhs[i]) && suffixNullable(*q, i + 1)) mark(rhs[i] - T);
+                }
+            }
+        }
+        K = (int)affected.size();
+
+        // 6. 受影响者的 Follow：扫描它们在右部中的每次出现
+        {
+            vector<TermSet> sets(K, TermSet(T));
+            vector<pair<int, int>> edges;
+            if (local[g.startSymbol - T] >= 0) sets[local[g.startSymbol - T]].set(g.endMarker);
+            for (int p = 0; p < P; ++p) {
+                int C = g.prodLhs[p] - T;
+                const int* rhs = g.rhsBegin(p);
+                for (int i = 0; i < g.rhsLength(p); ++i) {
+                    if (!g.isNonTerminal(rhs[i]) || local[rhs[i] - T] < 0) continue;
+                    int k = local[rhs[i] - T];
+                    sets[k].unionWith(suffixFirst(p, i + 1));
+                    if (!suffixNullable(p, i + 1)) continue;
+                    if (local[C] >= 0) edges.emplace_back(k, local[C]);
+                    else sets[k].unionWith(follow[C]);
+                }
+            }
+            DepGraph dg;
+            dg.build(K, edges);
+            solveBySccs(dg, sets, threadCount());
+            for (int k = 0; k < K; ++k) {
+                int B = affected[k];
+                if (sets[k] != follow[B]) d.followChanged[B] = 1;
+                follow[B] = move(sets[k]);
+            }
+        }
+        return d;
+    }
+
+    // 内存占用估计（字节）
+    size_t setBytes(const vector<TermSet>& s) const {
+        size_t b = s.capacity() * sizeof(TermSet);
+        for (auto& t : s) b += t.words() * sizeof(uint64_t);
+        return b;
+    }
+    size_t suffixBytes() const { return suffixWords.capacity() * sizeof(uint64_t) + suffixNull.capacity(); }
+
+    int threadCount() const {
+        if (threads > 0) return threads;
+        return G->numNonTerminals() >= 1024 ? (int)ThreadPool::defaultThreads() : 1;
+    }
+
+    // 打印 FIRST 集合：所有符号（$ 除外）按名字排序，集合内按名字排序，ε 写作 e
+    void printFirst(ostream& out) const {
+        const Grammar& g = *G;
+        out << "\nFIRST sets:\n";
+        for (int X : g.symbolsByName()) {
+            if (X == g.endMarker) continue;
+            out << g.names[X] << ": { ";
+            if (g.isTerminal(X)) {
+                out << g.names[X] << " ";
+            }
+            else {
+                // ε 按 "e" 的名字顺序插在对应位置
+                bool epsPending = nullable.test(X - g.numTerminals);
+                first[X - g.numTerminals].forEach([&](int t) {
+                    if (epsPending && t > g.epsilon) {
+                        out << g.names[g.epsilon] << " ";
+                        epsPending = false;
+                    }
+                    out << g.names[t] << " ";
+                });
+                if (epsPending) out << g.names[g.epsilon] << " ";
+            }
+            out << "}\n";
+        }
+    }
+
+    // 打印 FOLLOW 集合
+    void printFollow(ostream& out) const {
+        const Grammar& g = *G;
+        out << "\nFOLLOW sets:\n";
+        for (int X = g.numTerminals; X < g.numSymbols(); ++X) {
+            out << g.names[X] << ": { ";
+            follow[X - g.numTerminals].forEach([&](int t) { out << g.names[t] << " "; });
+            out << "}\n";
+        }
+    }
+};
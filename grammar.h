@@ -0,0 +1,505 @@
+﻿// 文法核心：LL1Parser 与 LR1Parser 共用的文法读取与符号表
+//
+// 所有文法符号在读入时映射为稠密整数编号，产生式以扁平数组存储，
+// 之后的分析与建表都只做数组下标访问，不再比较字符串。
+//
+// 编号布局：
+//   [0, numTerminals)            终结符，包含 "e"(ε) 与 "$"
+//   [numTerminals, numSymbols)   非终结符
+// 两个区间内部各自按名字排序，因此按编号顺序输出与原先按 set<string> 排序输出一致。
+//
+// 产生式右部支持 EBNF：X* / X+ / X? 以及分组 ( a | b c )*、( … )+、( … )?、( … )。
+// "(" ")" "*" "+" "?" 只有在没有被声明为终结符时才作为元符号，
+// 后缀既可以紧跟符号（T*），也可以单独成为一个记号（T *）。
+// 每个 EBNF 结构展开为一个以其文本命名的合成非终结符（如 "(+ T)*"），产生式排在用户产生式之后：
+//   LL 形式：(α)*  =>  L -> α L | e，且 L 标记为循环符号，由预测分析程序原地循环执行
+//   LR 形式：(α)*  =>  L -> L α | e，左递归使分析栈不随列表长度增长
+// (α)+ 在 LL 中为 α (α)*，在 LR 中为 L -> α | L α；(α)? 为 O -> α | e。
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// 读取文法时使用的临时符号表与 EBNF 展开（只在 Grammar::read 内部使用）
+struct GrammarLoader {
+    vector<string> names;
+    vector<char> kind;                  // 0 未声明, 1 终结符, 2 非终结符
+    vector<char> synthetic;             // 是否为 EBNF 展开出的合成非终结符
+    vector<char> loop;                  // 是否为 LL 形式的 (…)* 循环符号
+    unordered_map<string, int> ids;
+    int eps = -1;
+    bool leftRecursive = false;         // 重复结构展开为左递归（LR）还是循环（LL）
+
+    // 用户产生式与合成产生式分开存放，合成产生式最终排在后面
+    vector<int> lhs, offset{ 0 }, rhs;
+    vector<int> synLhs, synOffset{ 0 }, synRhs;
+
+    int intern(const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = (int)names.size();
+        ids.emplace(name, id);
+        names.push_back(name);
+        kind.push_back(0);
+        synthetic.push_back(0);
+        loop.push_back(0);
+        return id;
+    }
+
+    bool declared(const string& tok) const {
+        auto it = ids.find(tok);
+        return it != ids.end() && kind[it->second] != 0;
+    }
+
+    // 未被声明为符号时才是元符号
+    bool isMeta(const string& tok, const char* meta) const { return tok == meta && !declared(tok); }
+    bool isClose(const string& tok) const {
+        return !declared(tok) && (tok == ")" || tok == ")*" || tok == ")+" || tok == ")?");
+    }
+    static bool isPostfix(char c) { return c == '*' || c == '+' || c == '?'; }
+
+    // 解析一行产生式右部 line[pos..]，每个顶层候选式生成一个用户产生式
+    void parseRhs(int A, const string& line, size_t pos) {
+        // 记号以空白分隔，'|' 总是单独成为一个记号
+        vector<string> toks;
+        string cur;
+        for (size_t i = pos; i <= line.size(); ++i) {
+            char c = i < line.size() ? line[i] : ' ';
+            if (isspace((unsigned char)c) || c == '|') {
+                if (!cur.empty()) toks.push_back(cur);
+                cur.clear();
+                if (c == '|') toks.push_back("|");
+            }
+            else {
+                cur += c;
+            }
+        }
+
+        size_t i = 0;
+        while (true) {
+            bool hadTokens = false;
+            vector<int> seq = parseSequence(toks, i, 0, hadTokens);
+            if (hadTokens) addProduction(A, seq, false);
+            if (i < toks.size() && toks[i] == "|") {
+                ++i;
+                continue;
+            }
+            break;
+        }
+        if (i < toks.size()) fail("Unbalanced parentheses in production", line);
+    }
+
+    // 解析一个候选式（到 '|'、右括号或行尾为止）
+    vector<int> parseSequence(const vector<string>& toks, size_t& i, int depth, bool& hadTokens) {
+        vector<int> seq;
+        while (i < toks.size()) {
+            const string& t = toks[i];
+            if (t == "|" || isClose(t)) break;
+            hadTokens = true;
+            vector<int> elem;
+            if (isMeta(t, "(")) {
+                ++i;
+                vector<vector<int>> group;
+                while (true) {
+                    bool dummy = false;
+                    group.push_back(parseSequence(toks, i, depth + 1, dummy));
+                    if (i < toks.size() && toks[i] == "|") {
+                        ++i;
+                        continue;
+                    }
+                    break;
+                }
+                if (i >= toks.size() || !isClose(toks[i])) fail("Unbalanced parentheses in production", "");
+                char op = toks[i].size() > 1 ? toks[i][1] : 0;
+                ++i;
+                elem = construct(group, op);
+            }
+            else if (t.size() > 1 && isPostfix(t.back()) && !declared(t)) {
+                // 紧跟后缀的符号，如 T*
+                elem = construct({ { intern(t.substr(0, t.size() - 1)) } }, t.back());
+                ++i;
+            }
+            else {
+                int sym = intern(t);
+                if (sym != eps) elem.push_back(sym);
+                ++i;
+            }
+            // 单独的后缀记号作用于前一个元素
+            while (i < toks.size() && toks[i].size() == 1 && isPostfix(toks[i][0]) && !declared(toks[i])) {
+                elem = construct({ elem }, toks[i][0]);
+                ++i;
+            }
+            seq.insert(seq.end(), elem.begin(), elem.end());
+        }
+        return seq;
+    }
+
+    // 展开 EBNF 结构，返回在右部中代替它的符号串
+    vector<int> construct(const vector<vector<int>>& group, char op) {
+        if (op == 0 && group.size() == 1) return group[0]; // 单个候选式的分组直接内联
+        if (op == '+' && !leftRecursive) {
+            vector<int> body = construct(group, 0);
+            vector<int> star = construct(group, '*');
+            body.insert(body.end(), star.begin(), star.end());
+            return body;
+        }
+
+        string name = describe(group, op);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            if (!synthetic[it->second]) fail("EBNF construct clashes with declared symbol", name);
+            return { it->second }; // 同样的结构只展开一次
+        }
+        int X = intern(name);
+        kind[X] = 2;
+        synthetic[X] = 1;
+
+        for (auto& alt : group) {
+            vector<int> body;
+            if (op == '*' && leftRecursive) body.push_back(X);
+            body.insert(body.end(), alt.begin(), alt.end());
+            if (op == '*' && !leftRecursive) body.push_back(X);
+            addProduction(X, body, true);
+        }
+        if (op == '+') {
+            // 左递归形式：X -> α | X α
+            for (auto& alt : group) {
+                vector<int> body(1, X);
+                body.insert(body.end(), alt.begin(), alt.end());
+                addProduction(X, body, true);
+            }
+        }
+        if (op == '*' || op == '?') addProduction(X, {}, true);
+        if (op == '*' && !leftRecursive) loop[X] = 1;
+        return { X };
+    }
+
+    // 合成非终结符的名字：单个符号为 X*，否则为 (a | b c)*
+    string describe(const vector<vector<int>>& group, char op) const {
+        string s;
+        if (group.size() == 1 && group[0].size() == 1) {
+            s = names[group[0][0]];
+        }
+        else {
+            s = "(";
+            for (size_t k = 0; k < group.size(); ++k) {
+                if (k) s += " | ";
+                if (group[k].empty()) s += names[eps];
+                for (size_t j = 0; j < group[k].size(); ++j) {
+                    if (j) s += " ";
+                    s += names[group[k][j]];
+                }
+            }
+            s += ")";
+        }
+        if (op) s += op;
+        return s;
+    }
+
+    void addProduction(int A, const vector<int>& body, bool syn) {
+        vector<int>& L = syn ? synLhs : lhs;
+        vector<int>& O = syn ? synOffset : offset;
+        vector<int>& R = syn ? synRhs : rhs;
+        L.push_back(A);
+        R.insert(R.end(), body.begin(), body.end());
+        O.push_back((int)R.size());
+    }
+
+    static void fail(const char* msg, const string& what) {
+        cerr << msg << ": " << what << endl;
+        exit(1);
+    }
+};
+
+struct Grammar {
+    vector<string> names;               // 符号编号 -> 符号名
+    unordered_map<string, int> ids;     // 符号名 -> 符号编号
+    int numTerminals = 0;               // 终结符个数（含 e 与 $）
+    int epsilon = -1;                   // "e" 的编号
+    int endMarker = -1;                 // "$" 的编号
+    int startSymbol = -1;               // 开始符号
+
+    // 产生式：第 p 个产生式为 prodLhs[p] -> rhs[prodOffset[p] .. prodOffset[p+1])
+    // ε 产生式的右部为空
+    vector<int> prodLhs;
+    vector<int> prodOffset;
+    vector<int> rhs;
+    vector<int> prodNumber;             // 产生式在输入中的序号（从 1 开始），化简文法后保持不变
+                                        // EBNF 展开出的产生式接在用户产生式之后编号
+    vector<char> loop;                  // 符号是否为 (…)* 展开出的循环符号（LL 形式）
+
+    // 按左部归类的产生式：非终结符 A 的候选式为 alts[altOffset[A'] .. altOffset[A'+1])，
+    // 其中 A' = A - numTerminals
+    vector<int> altOffset;
+    vector<int> alts;
+
+    int numSymbols() const { return (int)names.size(); }
+    int numNonTerminals() const { return numSymbols() - numTerminals; }
+    int numProductions() const { return (int)prodLhs.size(); }
+
+    bool isTerminal(int sym) const { return sym >= 0 && sym < numTerminals; }
+    bool isNonTerminal(int sym) const { return sym >= numTerminals && sym < numSymbols(); }
+
+    const int* rhsBegin(int p) const { return rhs.data() + prodOffset[p]; }
+    const int* rhsEnd(int p) const { return rhs.data() + prodOffset[p + 1]; }
+    int rhsLength(int p) const { return prodOffset[p + 1] - prodOffset[p]; }
+
+    // 由输入序号找产生式下标，不存在（已被化简掉）时返回 -1
+    int productionIndex(int number) const {
+        auto it = lower_bound(prodNumber.begin(), prodNumber.end(), number);
+        if (it == prodNumber.end() || *it != number) return -1;
+        return int(it - prodNumber.begin());
+    }
+
+    bool isLoop(int sym) const { return loop[sym] != 0; }
+
+    const int* altsBegin(int A) const { return alts.data() + altOffset[A - numTerminals]; }
+    const int* altsEnd(int A) const { return alts.data() + altOffset[A - numTerminals + 1]; }
+
+    // 按名字查找符号编号，不存在时返回 -1
+    int lookup(const string& name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    // 所有符号按名字排序后的编号序列（终结符与非终结符混排）
+    vector<int> symbolsByName() const {
+        vector<int> order(numSymbols());
+        for (int i = 0; i < numSymbols(); ++i) order[i] = i;
+        sort(order.begin(), order.end(), [this](int a, int b) { return names[a] < names[b]; });
+        return order;
+    }
+
+    // 读取文法规则（不含待分析的输入串），格式：
+    //   开始符号
+    //   非终结符集合（空格分隔）
+    //   终结符集合（空格分隔）
+    //   产生式数量 P
+    //   P 行产生式，形如 A -> x y | z | e，右部可使用 EBNF
+    // 每行只扫描一遍，符号在扫描时即被编号。
+    // leftRecursive 为 true 时重复结构展开为左递归（供 LR 使用），否则展开为 LL 循环
+    void read(istream& in, bool leftRecursive = false) {
+        string line;
+        string start;
+        in >> start;
+        getline(in, line); // 读取剩余的换行符
+
+        // 符号先取临时编号
+        GrammarLoader ld;
+        ld.leftRecursive = leftRecursive;
+
+        // 非终结符集合
+        getline(in, line);
+        forEachToken(line, 0, line.size(), [&](const char* s, size_t len) {
+            ld.kind[ld.intern(string(s, len))] = 2;
+        });
+
+        // 终结符集合（包括 'e' 作为 ε，'$' 作为结束符）
+        getline(in, line);
+        forEachToken(line, 0, line.size(), [&](const char* s, size_t len) {
+            int id = ld.intern(string(s, len));
+            if (ld.kind[id] == 0) ld.kind[id] = 1;
+        });
+        int eps = ld.intern("e");
+        int end = ld.intern("$");
+        ld.kind[eps] = ld.kind[end] = 1;
+        ld.eps = eps;
+
+        // 输入产生式数量
+        int P;
+        in >> P;
+        getline(in, line); // 读取剩余的换行符
+
+        // 读取产生式：左部与右部先记为临时编号
+        for (int i = 0; i < P; ++i) {
+            getline(in, line);
+            size_t arrow = line.find("->");
+            if (arrow == string::npos) {
+                cerr << "Invalid production format: " << trimmed(line) << endl;
+                exit(1);
+            }
+            int lhs = -1;
+            forEachToken(line, 0, arrow, [&](const char* s, size_t len) {
+                lhs = ld.intern(string(s, len));
+            });
+            if (lhs < 0) {
+                cerr << "Invalid production format: " << trimmed(line) << endl;
+                exit(1);
+            }
+            if (ld.kind[lhs] == 0) ld.kind[lhs] = 2;
+
+            // 右部按 '|' 分成若干候选式，单独的 'e' 视为 ε
+            ld.parseRhs(lhs, line, arrow + 2);
+        }
+
+        // 未声明的符号：作为左部出现过的是非终结符，否则是终结符
+        vector<char>& kind = ld.kind;
+        for (int lhs : ld.lhs) {
+            if (kind[lhs] == 0) kind[lhs] = 2;
+        }
+        for (auto& k : kind) {
+            if (k == 0) k = 1;
+        }
+        int start0 = ld.intern(start);
+        if (kind[start0] == 1) {
+            cerr << "Start symbol " << start << " is declared as a terminal" << endl;
+            exit(1);
+        }
+        kind[start0] = 2;
+
+        // 重新编号：终结符在前，非终结符在后，各自按名字排序
+        vector<int> order(ld.names.size());
+        for (int i = 0; i < (int)order.size(); ++i) order[i] = i;
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            if (kind[a] != kind[b]) return kind[a] < kind[b];
+            return ld.names[a] < ld.names[b];
+        });
+        vector<int> remap(order.size());
+        names.assign(order.size(), string());
+        loop.assign(order.size(), 0);
+        ids.clear();
+        numTerminals = 0;
+        for (int i = 0; i < (int)order.size(); ++i) {
+            remap[order[i]] = i;
+            names[i] = ld.names[order[i]];
+            loop[i] = ld.loop[order[i]];
+            ids.emplace(names[i], i);
+            if (kind[order[i]] == 1) numTerminals++;
+        }
+        epsilon = remap[eps];
+        endMarker = remap[end];
+        startSymbol = remap[start0];
+
+        // 用户产生式在前，合成产生式在后
+        prodLhs.clear();
+        prodOffset.assign(1, 0);
+        rhs.clear();
+        auto append = [&](const vector<int>& L, const vector<int>& O, const vector<int>& R) {
+            for (size_t p = 0; p < L.size(); ++p) {
+                prodLhs.push_back(remap[L[p]]);
+                for (int k = O[p]; k < O[p + 1]; ++k) rhs.push_back(remap[R[k]]);
+                prodOffset.push_back((int)rhs.size());
+            }
+        };
+        append(ld.lhs, ld.offset, ld.rhs);
+        append(ld.synLhs, ld.synOffset, ld.synRhs);
+        prodNumber.resize(prodLhs.size());
+        for (size_t p = 0; p < prodLhs.size(); ++p) prodNumber[p] = int(p) + 1;
+
+        buildAlternatives();
+    }
+
+    // 按左部重建 altOffset / alts（计数排序，保持产生式原有顺序）
+    void buildAlternatives() {
+        int N = numNonTerminals();
+        altOffset.assign(N + 1, 0);
+        for (int A : prodLhs) altOffset[A - numTerminals + 1]++;
+        for (int i = 0; i < N; ++i) altOffset[i + 1] += altOffset[i];
+        alts.resize(prodLhs.size());
+        vector<int> fill(altOffset.begin(), altOffset.end() - 1);
+        for (int p = 0; p < numProductions(); ++p) {
+            alts[fill[prodLhs[p] - numTerminals]++] = p;
+        }
+    }
+
+    // 增量修改文法：符号表保持不变（新增符号会打乱编号布局，需要重新读入文法），
+    // 只能增删产生式。EBNF 展开出的循环符号由分析程序特殊处理，不允许修改。
+
+    // 解析一条产生式 "A -> x y"（单个候选式，e 表示 ε，不支持 EBNF），
+    // 符号都须已在文法中。失败时返回 false，原因写入 err
+    bool parseProduction(const string& line, int& A, vector<int>& body, string& err) const {
+        size_t arrow = line.find("->");
+        if (arrow == string::npos) {
+            err = "invalid production format: " + trimmed(line);
+            return false;
+        }
+        A = -1;
+        int count = 0;
+        forEachToken(line, 0, arrow, [&](const char* s, size_t len) {
+            A = lookup(string(s, len));
+            count++;
+        });
+        if (count != 1 || !isNonTerminal(A)) {
+            err = "left side is not a nonterminal: " + trimmed(line.substr(0, arrow));
+            return false;
+        }
+        if (isLoop(A)) {
+            err = "productions of " + names[A] + " cannot be edited";
+            return false;
+        }
+        body.clear();
+        bool ok = true;
+        forEachToken(line, arrow + 2, line.size(), [&](const char* s, size_t len) {
+            int x = lookup(string(s, len));
+            if (x < 0 || x == endMarker) {
+                if (ok) err = "unknown symbol: " + string(s, len);
+                ok = false;
+            }
+            else if (x != epsilon) {
+                body.push_back(x);
+            }
+        });
+        return ok;
+    }
+
+    // 追加产生式 A -> body，返回其下标。number 为 0 时序号接在现有最大序号之后，否则须大于现有序号
+    int addProduction(int A, const vector<int>& body, int number = 0) {
+        if (number == 0) number = prodNumber.empty() ? 1 : prodNumber.back() + 1;
+        prodLhs.push_back(A);
+        rhs.insert(rhs.end(), body.begin(), body.end());
+        prodOffset.push_back((int)rhs.size());
+        prodNumber.push_back(number);
+        buildAlternatives();
+        return numProductions() - 1;
+    }
+
+    // 删除下标为 p 的产生式；其后产生式的下标减一，输入序号不变
+    void removeProduction(int p) {
+        int len = rhsLength(p);
+        rhs.erase(rhs.begin() + prodOffset[p], rhs.begin() + prodOffset[p + 1]);
+        prodOffset.erase(prodOffset.begin() + p + 1);
+        for (size_t q = p + 1; q < prodOffset.size(); ++q) prodOffset[q] -= len;
+        prodLhs.erase(prodLhs.begin() + p);
+        prodNumber.erase(prodNumber.begin() + p);
+        buildAlternatives();
+    }
+
+    // 输出产生式右部（ε 产生式输出 e），每个符号后跟一个空格
+    void printRhs(ostream& out, int p) const {
+        if (rhsLength(p) == 0) {
+            out << names[epsilon] << " ";
+            return;
+        }
+        for (const int* s = rhsBegin(p); s != rhsEnd(p); ++s) {
+            out << names[*s] << " ";
+        }
+    }
+
+private:
+    // 辅助函数：对 s[b, e) 中以空白分隔的每个记号调用 f(起始指针, 长度)
+    template <typename F>
+    static void forEachToken(const string& s, size_t b, size_t e, F f) {
+        size_t i = b;
+        while (i < e) {
+            while (i < e && isspace((unsigned char)s[i])) ++i;
+            size_t j = i;
+            while (j < e && !isspace((unsigned char)s[j])) ++j;
+            if (j > i) f(s.data() + i, j - i);
+            i = j;
+        }
+    }
+
+    // 辅助函数：去除字符串首尾空白（仅用于报错信息）
+    static string trimmed(const string& s) {
+        size_t b = 0, e = s.size();
+        while (b < e && isspace((unsigned char)s[b])) ++b;
+        while (e > b && isspace((unsigned char)s[e - 1])) --e;
+        return s.substr(b, e - b);
+    }
+};
@@ -0,0 +1,899 @@
+﻿// LL(1) 预测分析程序（ll1v.cpp 与其他驱动程序共用）
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "adaptive_predict.h"
+#include "grammar.h"
+#include "first_follow.h"
+#include "parse_trace.h"
+#include "parse_tree.h"
+#include "reduce.h"
+#include "table_cache.h"
+#include "probes.h"
+#include "profile.h"
+#include "tokenizer.h"
+using namespace std;
+
+// LL1 解析器类
+class LL1Parser {
+private:
+    Grammar G;                                    // 文法（符号已编号）
+
+    // First 和 Follow 集合（位集表示）
+    FirstFollow sets;
+
+    // 分析表：非终结符 -> (终结符 -> 产生式编号)
+    map<int, map<int, int>> parseTable;
+    // 有冲突的表项：非终结符 -> (终结符 -> 全部候选的产生式编号)，parseTable 中只记第一个候选
+    map<int, map<int, vector<int>>> conflicts;
+
+    // 分析用的稠密预测表：predictTable[(X - numTerminals) * numTerminals + a] 为产生式下标，-1 表示出错，
+    // -2 - d 表示有冲突、由自适应预测的第 d 个决策点决定（见 adaptive_predict.h）。
+    // 由 parseTable 导出（见 buildPredictTable），构造、读缓存与增删产生式之后重建
+    vector<int16_t> predictTable;
+    mutable AdaptivePredictor adaptive;
+    // 各产生式右部的逆序，与 G.rhs 同样按 prodOffset 定位；预测时弹出 X 后整段复制到栈顶。
+    // 循环符号的产生式 L -> α L 逆序后以 L 开头，弹出再压入 L 与“L 留在栈中”效果相同
+    vector<int> reversedRhs;
+
+    // 预测链：从 M[X,a] 出发对同一个 a 连续预测，直到栈顶为终结符、X 展开出的符号都已弹出或遇到冲突表项，
+    // 一次查表完成整串预测（如 E -> T E'、T -> F T'、F -> id），合并后的符号一次压栈。
+    // chainTable 与 predictTable 同样排列，值为 chains 的下标，-1 表示 M[X,a] 没有表项或有冲突。
+    // 每条链在 chainData 中占 [begin, mid) 依次使用的产生式下标，[mid, end) 替换 X 压栈的符号（栈顶在后）
+    struct PredictChain {
+        uint32_t begin, mid, end;
+    };
+    vector<int32_t> chainTable;
+    vector<PredictChain> chains;
+    vector<int> chainData;
+
+public:
+    // 读取文法规则
+    void readGrammar() {
+        ProfileScope prof("readGrammar");
+        G.read(cin);
+
+        // 读取待分析的输入字符串（一整行，记号之间可以有空白）
+        getline(cin >> ws, inputString);
+    }
+
+    // 计算 First 集合
+    void computeFirst() {
+        ProfileScope prof("computeFirst");
+        sets.computeFirst(G);
+
+        // 打印 FIRST 集合
+        sets.printFirst(cout);
+    }
+
+    // 计算 Follow 集合
+    void computeFollow() {
+        ProfileScope prof("computeFollow");
+        sets.computeFollow();
+
+        // 打印 FOLLOW 集合
+        sets.printFollow(cout);
+    }
+
+    // 构造分析表
+    void buildParseTable() {
+        ProfileScope prof("buildParseTable");
+        for (int i = 0; i < G.numProductions(); ++i) {
+            addTableEntries(i);
+        }
+        buildPredictTable();
+
+        // 不在 buildParseTable() 中打印解析表，而是使用单独的函数
+    }
+
+    // 从磁盘缓存读取分析表（见 table_cache.h），文法与缓存一致时返回 true
+    bool loadParseTable() {
+        ProfileScope prof("loadParseTable");
+        vector<int32_t> key = grammarKey(G);
+        TableCache cache;
+        if (!cache.open(tableCachePath(kCacheLL1, key), kCacheLL1, key) || cache.sections() != 3) return false;
+        // 第 1 节：(非终结符, 终结符, 产生式编号) 三元组；
+        // 第 2 节：有冲突的表项，同样是三元组，同一表项的候选依次排列。
+        // 损坏或截断的缓存可能与文法键一致而表项越界，先逐项检查，不合法时返回 false 重新建表
+        for (int k = 1; k <= 2; ++k) {
+            const int32_t* e = cache.section(k);
+            size_t n = cache.sectionSize(k);
+            if (n % 3 != 0) return false;
+            for (size_t i = 0; i < n; i += 3) {
+                if (!G.isNonTerminal(e[i]) || !G.isTerminal(e[i + 1])) return false;
+                int p = G.productionIndex(e[i + 2]);
+                if (p < 0 || G.prodLhs[p] != e[i]) return false;
+            }
+        }
+        const int32_t* e = cache.section(1);
+        size_t n = cache.sectionSize(1);
+        parseTable.clear();
+        for (size_t k = 0; k < n; k += 3) {
+            parseTable[e[k]][e[k + 1]] = e[k + 2];
+        }
+        e = cache.section(2);
+        n = cache.sectionSize(2);
+        conflicts.clear();
+        for (size_t k = 0; k < n; k += 3) {
+            conflicts[e[k]][e[k + 1]].push_back(e[k + 2]);
+        }
+        buildPredictTable();
+        return true;
+    }
+
+    // 把分析表写入磁盘缓存（未启用缓存时什么也不做）
+    void saveParseTable() {
+        vector<vector<int32_t>> sections(3);
+        sections[0] = grammarKey(G);
+        string path = tableCachePath(kCacheLL1, sections[0]);
+        if (path.empty()) return;
+        for (auto& row : parseTable) {
+            for (auto& e : row.second) {
+                sections[1].push_back(row.first);
+                sections[1].push_back(e.first);
+                sections[1].push_back(e.second);
+            }
+        }
+        for (auto& row : conflicts) {
+            for (auto& e : row.second) {
+                for (int prodNum : e.second) {
+                    sections[2].push_back(row.first);
+                    sections[2].push_back(e.first);
+                    sections[2].push_back(prodNum);
+                }
+            }
+        }
+        if (!writeTableCache(path, kCacheLL1, sections)) {
+            cerr << "Cannot write parse table cache " << path << endl;
+        }
+    }
+
+    // 增加产生式（形如 "A -> x y"），只更新受影响的 First / Follow 集合与分析表行（化简结果有变化时重新建表，见 syncWithDeclared）
+    bool addProduction(const string& line) {
+        int A;
+        vector<int> body;
+        string err;
+        if (!declared.parseProduction(line, A, body, err)) {
+            cerr << "Cannot add production: " << err << endl;
+            return false;
+        }
+        int q = declared.addProduction(A, body);
+        cout << "\nAdded production " << declared.prodNumber[q] << ": " << declared.names[A] << " -> ";
+        declared.printRhs(cout, q);
+        cout << "\n";
+        // 用到了化简去掉的符号时 G 中没有这些符号，直接由 declared 重新建表
+        if (G.parseProduction(line, A, body, err)) {
+            int p = G.addProduction(A, body, declared.prodNumber[q]);
+            if (!syncWithDeclared()) updateParseTable(A, sets.update(A, body, p));
+        }
+        else {
+            syncWithDeclared();
+        }
+        return true;
+    }
+
+    // 删除输入序号为 number 的产生式
+    bool removeProduction(int number) {
+        int q = declared.productionIndex(number);
+        if (q < 0 || declared.isLoop(declared.prodLhs[q])) {
+            cerr << "Cannot remove production " << number << endl;
+            return false;
+        }
+        declared.removeProduction(q);
+        cout << "\nRemoved production " << number << "\n";
+        // 化简时已去掉的产生式不在 G 中，直接由 declared 重新建表
+        int p = G.productionIndex(number);
+        if (p >= 0) {
+            int A = G.prodLhs[p];
+            vector<int> body(G.rhsBegin(p), G.rhsEnd(p));
+            sets.eraseSuffixRows(p);
+            G.removeProduction(p);
+            if (!syncWithDeclared()) updateParseTable(A, sets.update(A, body));
+        }
+        else {
+            syncWithDeclared();
+        }
+        return true;
+    }
+
+    // 打印预测分析表
+    void printParseTable() {
+        ProfileScope prof("printParseTable");
+        // 收集所有终结符（$ 放在最后）
+        vector<int> termList;
+        for (int t = 0; t < G.numTerminals; ++t) {
+            if (t != G.epsilon && t != G.endMarker) // 'e' 作为特殊符号单独处理
+                termList.push_back(t);
+        }
+        termList.push_back(G.endMarker); // 添加结束符
+
+        // 打印 Action 表
+        cout << "\nLL(1) Parse Table (Action):\n";
+        // 打印表头
+        cout << left << setw(15) << "Non-Terminal";
+        for (int term : termList) {
+            cout << left << setw(15) << G.names[term];
+        }
+        cout << "\n";
+
+        // 打印每个非终结符的行
+        for (int A = G.numTerminals; A < G.numSymbols(); ++A) {
+            cout << left << setw(15) << G.names[A];
+            auto row = parseTable.find(A);
+            auto conflictRow = conflicts.find(A);
+            for (int term : termList) {
+                if (conflictRow != conflicts.end() && conflictRow->second.count(term)) {
+                    // 有冲突的表项列出全部候选，如 2/3
+                    string alts;
+                    for (int prodNum : conflictRow->second[term]) {
+                        alts += (alts.empty() ? "" : "/") + to_string(prodNum);
+                    }
+                    cout << left << setw(15) << alts;
+                }
+                else if (row != parseTable.end() && row->second.count(term)) {
+                    cout << left << setw(15) << row->second[term];
+                }
+                else {
+                    cout << left << setw(15) << "";
+                }
+            }
+            cout << "\n";
+        }
+
+        // 如果需要，可以分开 Action 和 Goto 表
+        // 但在LL(1)中，Goto表通常不需要，因为解析表已经包含了所有必要的信息
+    }
+
+    // 解析输入字符串；输出的详细程度由 PARSER_TRACE 选择（见 parse_trace.h）。
+    // 设置 PARSER_MAX_ERRORS=N 时出错后按恐慌模式恢复，一遍报告至多 N 个错误：
+    //   栈顶终结符不匹配      报错并弹出该终结符（视为漏写）
+    //   M[X,a] 为空          报错，跳过输入直到 a ∈ First(X) ∪ Follow(X) ∪ {$}；
+    //                        按新的 a 仍选不出产生式（无表项或自适应预测失败）则弹出 X
+    //   栈已空而输入未完      报错，跳到 First(开始符号) 中的记号后从开始符号重新分析
+    // 每步要么消耗输入、要么弹栈或按表展开，整个过程仍是线性的。未设置时遇到第一个错误即停止。
+    void parseInput() {
+        ProfileScope prof("parseInput");
+        // 分词：按声明的终结符做最长匹配（见 tokenizer.h），不属于任何终结符的字节记为未知记号
+        vector<int> inputTokens = tokenize(inputString);
+        inputTokens.push_back(G.endMarker); // 末尾加入 $
+
+        TraceLevel level = traceLevel();
+        bool full = level == kTraceFull;
+        size_t window = traceWindow();
+
+        // 初始化解析栈；full 级别下同时维护栈与剩余输入的文本
+        vector<int> parseStack;
+        parseStack.push_back(G.endMarker);
+        parseStack.push_back(G.startSymbol);
+        SymbolStrip stackText, inputText;
+        if (full) {
+            stackText.push(G.names[G.endMarker]);
+            stackText.push(G.names[G.startSymbol]);
+            for (int i = 0; i < (int)inputTokens.size(); i++) inputText.push(tokenName(inputTokens, i));
+        }
+
+        size_t ip = 0; // 输入指针
+        bool accept = false;
+
+        // 错误恢复：(出错的记号位置, 说明)
+        const char* limit = getenv("PARSER_MAX_ERRORS");
+        size_t maxErrors = limit ? strtoull(limit, nullptr, 10) : 0;
+        vector<pair<int, string>> errors;
+
+        // 输出表头
+        if (full) {
+            cout << "\nParsing Actions:\n";
+            cout << left << setw(30) << "Stack" << setw(30) << "Input" << "Action\n";
+        }
+        else if (level == kTraceProductions) {
+            cout << "\nProductions:\n";
+        }
+        // 本步的栈与剩余输入两列
+        auto columns = [&]() {
+            stackText.write(cout, 0, stackText.size(), window, true, 30);
+            inputText.write(cout, ip, inputText.size(), window, false, 30);
+        };
+        // 输出一行恢复动作
+        auto recoveryRow = [&](const string& action) {
+            if (!full) return;
+            columns();
+            cout << "error, " << action << "\n";
+        };
+        // 记录一个错误；返回 false 表示不再继续（未启用恢复或已达上限）
+        auto report = [&](const string& message) {
+            errors.emplace_back(ip, message);
+            return errors.size() < maxErrors;
+        };
+        auto popTop = [&]() {
+            parseStack.pop_back();
+            if (full) stackText.pop();
+        };
+        // 自适应预测用的向前看
+        auto la = [&](size_t i) { return inputTokens[min(ip + i, inputTokens.size() - 1)]; };
+        // 输出所用的产生式，full 级别下同时更新栈的文本
+        auto usePrediction = [&](int p, int a) {
+            int prodNum = G.prodNumber[p];
+            PARSER_PROBE3(ll1, predict, G.prodLhs[p], a, prodNum);
+            if (level != kTraceNone) {
+                if (full) columns();
+                cout << "Use production " << prodNum << ": " << G.names[G.prodLhs[p]] << " -> ";
+                G.printRhs(cout, p);
+                cout << "\n";
+            }
+            if (full) {
+                stackText.pop();
+                for (const int* s = G.rhsEnd(p); s != G.rhsBegin(p); ) stackText.push(G.names[*--s]);
+            }
+        };
+
+        while (!parseStack.empty()) {
+            // 获取栈顶符号
+            int X = parseStack.back();
+            int a = inputTokens[ip];
+
+            // 检查是否接受
+            if (X == G.endMarker && a == G.endMarker) {
+                if (full) {
+                    columns();
+                    cout << (errors.empty() ? "accept\n" : "end\n");
+                }
+                accept = errors.empty();
+                break;
+            }
+
+            // 如果 X 是终结符
+            if (G.isTerminal(X)) {
+                if (X == a) {
+                    // match
+                    PARSER_PROBE1(ll1, match, a);
+                    if (full) {
+                        columns();
+                        cout << "match\n";
+                        stackText.pop();
+                    }
+                    parseStack.pop_back();
+                    ip++;
+                }
+                else if (maxErrors == 0) {
+                    // error
+                    if (full) {
+                        columns();
+                        cout << "error\n";
+                    }
+                    break;
+                }
+                else if (X == G.endMarker) {
+                    if (!report("unexpected " + tokenName(inputTokens, ip) + " after complete input")) {
+                        recoveryRow("stop");
+                        break;
+                    }
+                    // 跳到能开始一个新句子的记号，从开始符号重新分析
+                    const TermSet& first = sets.first[G.startSymbol - G.numTerminals];
+                    while (a != G.endMarker && (a < 0 || !first.test(a))) {
+                        recoveryRow("skip " + tokenName(inputTokens, ip));
+                        a = inputTokens[++ip];
+                    }
+                    if (a != G.endMarker) {
+                        recoveryRow("restart " + G.names[G.startSymbol]);
+                        parseStack.push_back(G.startSymbol);
+                        if (full) stackText.push(G.names[G.startSymbol]);
+                    }
+                }
+                else {
+                    if (!report("expected " + G.names[X] + " before " + tokenName(inputTokens, ip))) {
+                        recoveryRow("stop");
+                        break;
+                    }
+                    recoveryRow("pop " + G.names[X]);
+                    popTop();
+                }
+            }
+            else { // X 是非终结符
+                // 查找 M[X, a]：没有冲突时按预测链一次完成到下一个终结符为止的各步预测，
+                // 其中的产生式仍逐个输出；有冲突时由自适应预测决定
+                int cell = predict(X, a);
+                if (cell >= 0) {
+                    const PredictChain& chain = chains[chainTable[(size_t)(X - G.numTerminals) * G.numTerminals + a]];
+                    for (uint32_t k = chain.begin; k < chain.mid; ++k) usePrediction(chainData[k], a);
+                    applyChain(parseStack, chain);
+                    continue;
+                }
+                int p = cell < -1 ? adaptive.predict(-2 - cell, parseStack, la) : cell;
+                if (p >= 0) {
+                    usePrediction(p, a);
+                    // 弹出栈顶，将产生式右部逆序压栈（ε 产生式右部为空）
+                    expand(parseStack, p);
+                }
+                else if (maxErrors == 0) {
+                    // error
+                    if (full) {
+                        columns();
+                        cout << "error\n";
+                    }
+                    break;
+                }
+                else {
+                    if (!report("unexpected " + tokenName(inputTokens, ip) + " in " + G.names[X])) {
+                        recoveryRow("stop");
+                        break;
+                    }
+                    // 跳到同步记号
+                    const TermSet& first = sets.first[X - G.numTerminals];
+                    const TermSet& follow = sets.follow[X - G.numTerminals];
+                    while (a != G.endMarker && (a < 0 || (!first.test(a) && !follow.test(a)))) {
+                        recoveryRow("skip " + tokenName(inputTokens, ip));
+                        a = inputTokens[++ip];
+                    }
+                    // 按同步后的记号重新判断：仍无表项，或自适应预测没有可行的候选时弹出 X
+                    int next = predict(X, a);
+                    if (next == -1 || (next < -1 && adaptive.predict(-2 - next, parseStack, la) < 0)) {
+                        recoveryRow("pop " + G.names[X]);
+                        popTop();
+                    }
+                }
+            }
+        }
+
+        if (accept) {
+            cout << "\nParsing accepted.\n";
+            printTree(inputTokens);
+        }
+        else {
+            if (maxErrors > 0) {
+                cout << "\nSyntax errors: " << errors.size() << (errors.size() >= maxErrors ? " (limit reached)" : "") << "\n";
+                for (auto& e : errors) {
+                    cout << "  at token " << e.first << ": " << e.second << "\n";
+                }
+            }
+            cout << "\nParsing failed.\n";
+        }
+    }
+
+    // 设置了环境变量 PARSER_TREE 时构造并输出已接受输入的具体语法树
+    void printTree(vector<int> inputTokens) {
+        const char* v = getenv("PARSER_TREE");
+        if (v == nullptr || *v == 0) return;
+        ProfileScope prof("buildTree");
+        inputTokens.pop_back(); // 去掉 $
+        ParseTree tree;
+        recognize(inputTokens, nullptr, &tree);
+        profiler().stat("tree_nodes", (double)tree.size());
+        profiler().stat("bytes_tree", (double)tree.bytes());
+        cout << "\nParse tree:\n";
+        tree.write(cout, G);
+    }
+
+    // 以下供其他驱动程序使用（不输出分析过程）
+
+    // 从 in 读取文法并化简（不含待分析的输入串），化简报告写到 log
+    void loadGrammar(istream& in, ostream& log) {
+        G.read(in);
+        reduce(log);
+    }
+
+    // 计算 First / Follow 并构造分析表
+    void buildTables() {
+        sets.computeFirst(G);
+        sets.computeFollow();
+        buildParseTable();
+    }
+
+    const Grammar& grammar() const { return G; }
+
+    // 分析表：非终结符 -> (终结符 -> 产生式编号)
+    const map<int, map<int, int>>& table() const { return parseTable; }
+
+    // 有冲突（由自适应预测决定）的表项数
+    size_t conflictCount() const {
+        size_t n = 0;
+        for (auto& row : conflicts) n += row.second.size();
+        return n;
+    }
+
+    size_t tableEntries() const {
+        size_t n = 0;
+        for (auto& row : parseTable) n += row.second.size();
+        return n;
+    }
+
+    // 判断终结符编号序列（不含末尾的 $）能否被接受；trace 非空时记录推导中依次使用的产生式编号，
+    // tree 非空时同时构造具体语法树（见 parse_tree.h，拒绝时树不完整）。
+    // 只读分析表，每次调用使用自己的分析栈，多个线程可以同时调用（见 batch.cpp）
+    bool recognize(const vector<int>& tokens, vector<int>* trace = nullptr, ParseTree* tree = nullptr) const {
+        size_t ip = 0;
+        return recognize([&]() { return ip < tokens.size() ? tokens[ip++] : G.endMarker; }, trace, tree);
+    }
+
+    // 流式版本：每次调用 next() 取下一个终结符编号，输入结束后返回 $；
+    // 记号一个个到来时即可分析（见 pipeline.cpp），不需要先收齐整个序列
+    template <typename Next>
+    bool recognize(Next next, vector<int>* trace = nullptr, ParseTree* tree = nullptr) const {
+        vector<int> parseStack;
+        parseStack.push_back(G.endMarker);
+        parseStack.push_back(G.startSymbol);
+        vector<uint32_t> nodeStack; // 构造语法树时与 parseStack 对应（不含栈底的 $）
+        uint32_t pos = 0;           // 已匹配的记号数
+        if (tree) nodeStack.push_back(tree->start(G.startSymbol));
+        // 自适应预测向前看时多读的记号，之后按顺序先从这里取
+        vector<int> ahead;
+        size_t head = 0;
+        int a = next();
+        auto advance = [&]() {
+            if (head == ahead.size()) {
+                a = next();
+                return;
+            }
+            a = ahead[head++];
+            if (head == ahead.size()) {
+                ahead.clear();
+                head = 0;
+            }
+        };
+        auto la = [&](size_t i) {
+            if (i == 0) return a;
+            while (ahead.size() - head < i) ahead.push_back(next());
+            return ahead[head + i - 1];
+        };
+        while (true) {
+            int X = parseStack.back();
+            if (X == G.endMarker) {
+                if (a != G.endMarker) return false;
+                if (tree) tree->finish();
+                return true;
+            }
+            if (G.isTerminal(X)) {
+                if (X != a) return false;
+                PARSER_PROBE1(ll1, match, a);
+                parseStack.pop_back();
+                if (tree) {
+                    tree->match(nodeStack.back(), pos);
+                    nodeStack.pop_back();
+                }
+                ++pos;
+                advance();
+                continue;
+            }
+            // 一次查表完成整条预测链；语法树与 trace 仍按其中的产生式逐个记录
+            int c = a < 0 ? -1 : chainTable[(size_t)(X - G.numTerminals) * G.numTerminals + a];
+            if (c >= 0) {
+                const PredictChain& chain = chains[c];
+                for (uint32_t k = chain.begin; k < chain.mid; ++k) {
+                    int p = chainData[k];
+                    PARSER_PROBE3(ll1, predict, G.prodLhs[p], a, G.prodNumber[p]);
+                    if (trace) trace->push_back(G.prodNumber[p]);
+                    if (tree) expandNode(*tree, nodeStack, p, pos);
+                }
+                applyChain(parseStack, chain);
+                continue;
+            }
+            int p = predict(X, a);
+            if (p > -2) return false;
+            p = adaptive.predict(-2 - p, parseStack, la);
+            if (p < 0) return false;
+            PARSER_PROBE3(ll1, predict, X, a, G.prodNumber[p]);
+            if (trace) trace->push_back(G.prodNumber[p]);
+            expand(parseStack, p);
+            if (tree) expandNode(*tree, nodeStack, p, pos);
+        }
+    }
+
+    // 运行解析器
+    void run() {
+        readGrammar();
+        {
+            ProfileScope prof("reduceGrammar");
+            reduce(cerr); // 去掉无用符号与产生式
+        }
+        computeFirst();
+        computeFollow();
+        bool cached = loadParseTable();
+        if (!cached) {
+            buildParseTable();
+            saveParseTable();
+        }
+        printParseTable(); // 输出预测分析表
+        parseInput();
+        editGrammar();
+        reportProfile(cached);
+    }
+
+    // 输出 profile 报告（见 profile.h），未启用时什么也不做
+    void reportProfile(bool cached) {
+        Profiler& prof = profiler();
+        if (!prof.enabled()) return;
+        size_t entries = 0;
+        for (auto& row : parseTable) entries += row.second.size();
+        prof.stat("symbols", G.numSymbols());
+        prof.stat("productions", G.numProductions());
+        prof.stat("table_entries", (double)entries);
+        prof.stat("cache_hit", cached);
+        prof.stat("bytes_parseTable", (double)mapBytes(parseTable));
+        prof.stat("bytes_predictTable", (double)(predictTable.size() * sizeof(int16_t) + reversedRhs.size() * sizeof(int)));
+        prof.stat("predict_chains", (double)chains.size());
+        prof.stat("chain_productions", (double)chainProductions());
+        prof.stat("bytes_predictChains", (double)(chainTable.size() * sizeof(int32_t) + chains.size() * sizeof(PredictChain) + chainData.size() * sizeof(int)));
+        prof.stat("conflict_cells", (double)conflictCount());
+        prof.stat("adaptive_predictions", (double)adaptive.predictionCount());
+        prof.stat("adaptive_full_context", (double)adaptive.fullContextCount());
+        prof.stat("adaptive_dfa_states", (double)adaptive.dfaStates());
+        prof.stat("bytes_First", (double)sets.setBytes(sets.first));
+        prof.stat("bytes_Follow", (double)sets.setBytes(sets.follow));
+        prof.stat("bytes_suffixFirst", (double)sets.suffixBytes());
+        vector<int32_t> key = grammarKey(G);
+        prof.report("ll1", fnv1a(key.data(), key.size() * sizeof(int32_t)));
+    }
+
+    // 读入之后的修改命令，每行一条：
+    //   add A -> x y    增加产生式
+    //   remove N        删除输入序号为 N 的产生式
+    //   parse s         用当前的分析表分析输入串 s
+    //   print           输出当前的 First / Follow 集合与分析表
+    void editGrammar() {
+        string line;
+        while (getline(cin, line)) {
+            istringstream in(line);
+            string cmd;
+            if (!(in >> cmd)) continue;
+            if (cmd == "add") {
+                string rest;
+                getline(in, rest);
+                addProduction(rest);
+            }
+            else if (cmd == "remove") {
+                int number;
+                if (in >> number) removeProduction(number);
+                else cerr << "Usage: remove N" << endl;
+            }
+            else if (cmd == "parse") {
+                getline(in >> ws, inputString);
+                parseInput();
+            }
+            else if (cmd == "print") {
+                sets.printFirst(cout);
+                sets.printFollow(cout);
+                printParseTable();
+            }
+            else {
+                cerr << "Unknown command: " << cmd << endl;
+            }
+        }
+    }
+
+private:
+    string inputString; // 待分析的输入字符串
+    Tokenizer lexer;    // 由终结符集合构造的分词器
+    vector<pair<int, int>> tokenSpans; // 每个输入记号在 inputString 中的 [起点, 终点)
+
+    // 化简前的文法（含此后的修改）。化简去掉的符号与产生式在修改之后可能重新有用（增加的产生式用到被去掉的终结符，
+    // 或使不可达的非终结符重新可达），修改也可能使原本有用的部分变得无用、使候选式重复，
+    // 所以每次修改同时记在 declared 上并重新化简：结果与增量修改后的 G 相同时照常增量更新，否则换成化简结果并重新建表
+    Grammar declared;
+
+    // 化简文法，被去掉的内容写到 log
+    void reduce(ostream& log) {
+        declared = G;
+        reduceGrammar(G, log);
+    }
+
+    // 修改之后 declared 的化简结果与 G 不同时，换成化简结果并重新建表
+    bool syncWithDeclared() {
+        Grammar reduced = declared;
+        ostringstream log;
+        reduceGrammar(reduced, log);
+        if (grammarKey(reduced) == grammarKey(G)) return false;
+        cerr << log.str();
+        G = move(reduced);
+        lexer = Tokenizer();
+        parseTable.clear();
+        conflicts.clear();
+        sets.computeFirst(G);
+        sets.computeFollow();
+        buildParseTable();
+        return true;
+    }
+
+    // 填写 M[A,a]，若已有其他产生式则记为冲突（见 buildPredictTable）
+    void setEntry(int A, int a, int prodNum) {
+        auto& row = parseTable[A];
+        auto it = row.find(a);
+        if (it == row.end()) {
+            row[a] = prodNum;
+            return;
+        }
+        if (it->second == prodNum) return;
+        vector<int>& alts = conflicts[A][a];
+        if (alts.empty()) alts.push_back(it->second);
+        if (find(alts.begin(), alts.end(), prodNum) == alts.end()) alts.push_back(prodNum);
+    }
+
+    // 把产生式 i 填入分析表
+    void addTableEntries(int i) {
+        int A = G.prodLhs[i];
+
+        // 计算 First(alpha)
+        TermSetView firstAlpha = sets.suffixFirst(i, 0);
+        bool nullable = sets.suffixNullable(i, 0);
+
+        // 对于 a ∈ First(alpha) - {e}, M[A,a] = 产生式编号（输入序号，从 1 开始）
+        int prodNum = G.prodNumber[i];
+        firstAlpha.forEach([&](int a) {
+            setEntry(A, a, prodNum);
+        });
+
+        // 如果 e ∈ First(alpha), 对于 b ∈ Follow(A), M[A,b] = 产生式编号
+        if (nullable) {
+            sets.follow[A - G.numTerminals].forEach([&](int b) {
+                setEntry(A, b, prodNum);
+            });
+        }
+    }
+
+    // 增删产生式之后重填受影响的行：被修改的左部 A、Follow 有变化的非终结符、
+    // 以及后缀表有变化的产生式的左部
+    void updateParseTable(int A, const FirstFollowDelta& d) {
+        int T = G.numTerminals;
+        vector<char> dirty(G.numNonTerminals(), 0);
+        dirty[A - T] = 1;
+        for (int B = 0; B < G.numNonTerminals(); ++B) {
+            if (d.followChanged[B]) dirty[B] = 1;
+        }
+        for (int p = 0; p < G.numProductions(); ++p) {
+            if (d.prodTouched[p]) dirty[G.prodLhs[p] - T] = 1;
+        }
+        for (int B = 0; B < G.numNonTerminals(); ++B) {
+            if (!dirty[B]) continue;
+            parseTable.erase(B + T);
+            conflicts.erase(B + T);
+            for (const int* q = G.altsBegin(B + T); q != G.altsEnd(B + T); ++q) {
+                addTableEntries(*q);
+            }
+        }
+        buildPredictTable(); // 增删产生式会移动产生式下标，整表重建
+    }
+
+    // 由 parseTable 生成稠密预测表与逆序右部
+    void buildPredictTable() {
+        int T = G.numTerminals;
+        if (G.numProductions() > INT16_MAX) {
+            cerr << "Grammar has too many productions (" << G.numProductions() << ") for the prediction table.\n";
+            exit(1);
+        }
+        predictTable.assign((size_t)G.numNonTerminals() * T, -1);
+        for (auto& row : parseTable) {
+            int16_t* r = predictTable.data() + (size_t)(row.first - T) * T;
+            for (auto& e : row.second) r[e.first] = (int16_t)G.productionIndex(e.second);
+        }
+
+        // 有冲突的表项交给自适应预测；模拟时按表展开非终结符，左递归的文法无法这样处理
+        adaptive.reset(G, sets, predictTable);
+        bool leftRecursive = !conflicts.empty() && hasLeftRecursion();
+        for (auto& row : conflicts) {
+            int16_t* r = predictTable.data() + (size_t)(row.first - T) * T;
+            for (auto& e : row.second) {
+                cerr << "Parse table conflict at M[" << G.names[row.first] << "," << G.names[e.first] << "] between productions ";
+                for (size_t k = 0; k < e.second.size(); ++k) cerr << (k == 0 ? "" : " and ") << e.second[k];
+                if (leftRecursive) {
+                    cerr << endl << "Grammar is left-recursive; the conflict cannot be resolved by adaptive prediction" << endl;
+                    exit(1);
+                }
+                cerr << ", resolved by adaptive prediction" << endl;
+                vector<int> alts;
+                for (int prodNum : e.second) alts.push_back(G.productionIndex(prodNum));
+                r[e.first] = (int16_t)(-2 - adaptive.addDecision(row.first, alts));
+            }
+        }
+        if (adaptive.size() > (size_t)INT16_MAX - 1) {
+            cerr << "Grammar has too many conflicting table entries (" << adaptive.size() << ") for the prediction table.\n";
+            exit(1);
+        }
+        reversedRhs.resize(G.rhs.size());
+        for (int p = 0; p < G.numProductions(); ++p) {
+            reverse_copy(G.rhsBegin(p), G.rhsEnd(p), reversedRhs.begin() + G.prodOffset[p]);
+        }
+        buildPredictChains();
+    }
+
+    // 由 predictTable 生成每个无冲突表项的预测链。不消耗输入的预测链中同一个非终结符再次出现在栈顶意味着左递归，
+    // 所以链长不超过非终结符数（左递归的文法本来就有冲突，这里只是保证构造一定结束）
+    void buildPredictChains() {
+        int T = G.numTerminals;
+        chainTable.assign(predictTable.size(), -1);
+        chains.clear();
+        chainData.clear();
+        vector<int> stack;
+        for (int X = T; X < G.numSymbols(); ++X) {
+            for (int a = 0; a < T; ++a) {
+                if (predict(X, a) < 0) continue;
+                PredictChain chain;
+                chain.begin = (uint32_t)chainData.size();
+                stack.assign(1, X);
+                int p;
+                while (!stack.empty() && G.isNonTerminal(stack.back()) && (p = predict(stack.back(), a)) >= 0
+                    && (int)(chainData.size() - chain.begin) < G.numNonTerminals()) {
+                    stack.pop_back();
+                    for (const int* s = G.rhsEnd(p); s != G.rhsBegin(p); ) stack.push_back(*--s);
+                    chainData.push_back(p);
+                }
+                chain.mid = (uint32_t)chainData.size();
+                chainData.insert(chainData.end(), stack.begin(), stack.end());
+                chain.end = (uint32_t)chainData.size();
+                chainTable[(size_t)(X - T) * T + a] = (int32_t)chains.size();
+                chains.push_back(chain);
+            }
+        }
+    }
+
+    size_t chainProductions() const {
+        size_t n = 0;
+        for (auto& c : chains) n += c.mid - c.begin;
+        return n;
+    }
+
+    // 按预测链替换栈顶的非终结符
+    void applyChain(vector<int>& parseStack, const PredictChain& chain) const {
+        size_t base = parseStack.size() - 1;
+        size_t n = chain.end - chain.mid;
+        parseStack.resize(base + n);
+        if (n > 0) memcpy(parseStack.data() + base, chainData.data() + chain.mid, n * sizeof(int));
+    }
+
+    // 语法树：栈顶结点按产生式 p 展开，子结点逆序入栈
+    void expandNode(ParseTree& tree, vector<uint32_t>& nodeStack, int p, uint32_t pos) const {
+        uint32_t first = tree.expand(nodeStack.back(), p, G, pos);
+        nodeStack.pop_back();
+        for (uint32_t c = first + G.rhsLength(p); c-- > first; ) nodeStack.push_back(c);
+    }
+
+    // 是否有左递归 A =>+ A β（经由可空符号或单产生式的环也算）
+    bool hasLeftRecursion() const {
+        int T = G.numTerminals, N = G.numNonTerminals();
+        vector<pair<int, int>> edges;
+        for (int p = 0; p < G.numProductions(); ++p) {
+            for (const int* s = G.rhsBegin(p); s != G.rhsEnd(p) && G.isNonTerminal(*s); ++s) {
+                if (*s == G.prodLhs[p]) return true;
+                edges.emplace_back(G.prodLhs[p] - T, *s - T);
+                if (!sets.isNullable(*s)) break;
+            }
+        }
+        DepGraph dg;
+        dg.build(N, edges);
+        vector<int> comp;
+        return tarjanScc(dg, comp) < N; // 有多于一个非终结符的强连通分量
+    }
+
+    // M[X,a] 对应的产生式下标，没有表项（或 a 是未知记号）时为 -1，有冲突时为 -2 - 决策点编号
+    int predict(int X, int a) const {
+        if (a < 0) return -1;
+        return predictTable[(size_t)(X - G.numTerminals) * G.numTerminals + a];
+    }
+
+    // 预测：用产生式 p 替换栈顶的非终结符
+    void expand(vector<int>& parseStack, int p) const {
+        size_t base = parseStack.size() - 1;
+        int n = G.rhsLength(p);
+        parseStack.resize(base + n);
+        if (n > 0) memcpy(parseStack.data() + base, reversedRhs.data() + G.prodOffset[p], n * sizeof(int));
+    }
+
+    // 输入记号的名字：未知字符没有符号编号，直接取原文
+    string tokenName(const vector<int>& tokens, int i) {
+        if (tokens[i] >= 0) return G.names[tokens[i]];
+        return inputString.substr(tokenSpans[i].first, tokenSpans[i].second - tokenSpans[i].first);
+    }
+
+    // 分词函数：按终结符最长匹配（见 tokenizer.h），不是终结符的字符记为 -1
+    vector<int> tokenize(const string& input) {
+        if (!lexer.built()) lexer.build(G);
+        return lexer.tokenize(input, &tokenSpans);
+    }
+};
@@ -0,0 +1,78 @@
+﻿// 流式 LL(1) 分析：输入不整体读入内存，长度不受限制
+//
+// 编译：g++ -O2 -std=c++17 llstream.cpp -o llstream
+// 用法：llstream [--buffer 字节数] 文法文件 [输入文件]
+//
+// 文法文件采用仓库的文法格式（不含待分析的输入串）；输入文件（省略时为标准输入）整个作为一个待分析的串，
+// 可以跨越任意多行。TokenStream（见 tokenizer.h）经固定大小的缓冲区（默认 64 KiB）读入并分词，
+// LL1Parser 的流式 recognize 每次取一个记号，已匹配的记号随即丢弃，
+// 内存只取决于分析栈的深度（嵌套层数），与输入长度无关；循环符号展开的长列表不会加深分析栈。
+// 有冲突的表项由自适应预测决定时，需要暂存向前看的记号（见 adaptive_predict.h）。
+// 结果写到标准输出，记号数、字节数、耗时、吞吐量与峰值内存写到标准错误；接受时退出码为 0，拒绝时为 1。
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ll1_parser.h"
+#include "profile.h"
+#include "tokenizer.h"
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t bufferSize = 1 << 16;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--buffer") && i + 1 < argc) bufferSize = strtoull(argv[++i], nullptr, 10);
+        else files.push_back(argv[i]);
+    }
+    if (files.empty() || files.size() > 2) {
+        cerr << "Usage: llstream [--buffer BYTES] GRAMMAR [INPUT]" << endl;
+        return 2;
+    }
+    ifstream grammarFile(files[0]);
+    if (!grammarFile) {
+        cerr << "Cannot open grammar file " << files[0] << endl;
+        return 2;
+    }
+    ifstream inputFile;
+    if (files.size() == 2) {
+        inputFile.open(files[1], ios::binary);
+        if (!inputFile) {
+            cerr << "Cannot open input file " << files[1] << endl;
+            return 2;
+        }
+    }
+    istream& input = files.size() == 2 ? inputFile : cin;
+    ios::sync_with_stdio(false);
+
+    LL1Parser parser;
+    parser.loadGrammar(grammarFile, cerr);
+    parser.buildTables();
+    const Grammar& G = parser.grammar();
+    Tokenizer lexer;
+    lexer.build(G);
+
+    auto start = chrono::steady_clock::now();
+    TokenStream tokens(lexer, input, G.endMarker, bufferSize);
+    int last = G.endMarker;
+    bool accepted = parser.recognize([&]() { return last = tokens.next(); });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (accepted) {
+        cout << "accepted (" << tokens.count() << " tokens)" << endl;
+    }
+    else if (last == G.endMarker) {
+        cout << "rejected at end of input (" << tokens.count() << " tokens)" << endl;
+    }
+    else {
+        // 自适应预测向前看时，最近取出的记号可能在出错位置之后
+        cout << "rejected at line " << tokens.line() << ", byte " << tokens.offset() << " near "
+            << (last >= 0 ? "'" + G.names[last] + "'" : string("unknown character")) << " (token " << tokens.count() << ")" << endl;
+    }
+    cerr << tokens.count() << " tokens, " << tokens.bytes() << " bytes, " << seconds * 1000 << " ms, "
+        << (seconds > 0 ? tokens.bytes() / seconds / 1e6 : 0) << " MB/s, peak RSS " << Profiler::peakRssKb() << " KB" << endl;
+    return accepted ? 0 : 1;
+}
@@ -0,0 +1,1154 @@
+﻿// LR(1) 分析程序（lr1v.cpp 与其他驱动程序共用）
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "grammar.h"
+#include "first_follow.h"
+#include "reduce.h"
+#include "table_cache.h"
+#include "probes.h"
+#include "profile.h"
+#include "tokenizer.h"
+using namespace std;
+
+// 定义LR(1)项目：产生式下标、点的位置与向前看集合的编号（见 LookaheadPool），共 12 字节。
+// 核心（产生式与点）相同的项目合并为一个，各自的向前看终结符放在同一个集合里
+struct LR1Item {
+    int32_t prodId; // 产生式下标（从 0 开始）
+    int32_t dot; // 点的位置
+    int32_t lookaheads; // 向前看终结符集合的编号
+
+    LR1Item(int pid, int d, int la)
+        : prodId(pid), dot(d), lookaheads(la) {
+    }
+
+    bool operator<(const LR1Item& other) const {
+        if (prodId != other.prodId)
+            return prodId < other.prodId;
+        if (dot != other.dot)
+            return dot < other.dot;
+        return lookaheads < other.lookaheads;
+    }
+
+    bool operator==(const LR1Item& other) const {
+        return prodId == other.prodId && dot == other.dot && lookaheads == other.lookaheads;
+    }
+};
+
+// 项目集：按核心 (prodId, dot) 排序的扁平数组，每个核心只出现一次。
+// 向前看集合在池中去重，相同的集合编号相同，所以两个项目集相等当且仅当数组逐项相等
+typedef vector<LR1Item> LR1ItemSet;
+
+// 向前看集合池：每个不同的终结符集合只存一份位集，项目以编号引用。
+// 位集依次存放在一个扁平数组中，用开放定址的散列表去重
+class LookaheadPool {
+public:
+    void reset(int numTerminals) {
+        W = (numTerminals + 63) / 64;
+        words.clear();
+        slots.assign(1024, -1);
+        count = 0;
+    }
+
+    // 位集 w（W 个字）的编号，没有时加入
+    int intern(const uint64_t* w) {
+        if (2 * (count + 1) > slots.size()) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t h = hashRow(w) & mask; ; h = (h + 1) & mask) {
+            int id = slots[h];
+            if (id < 0) {
+                slots[h] = (int)count;
+                words.insert(words.end(), w, w + W);
+                return (int)count++;
+            }
+            if (equal(w, w + W, row(id))) return id;
+        }
+    }
+
+    // 只含终结符 a 的集合
+    int singleton(int a) {
+        vector<uint64_t> w(W, 0);
+        w[a >> 6] |= uint64_t(1) << (a & 63);
+        return intern(w.data());
+    }
+
+    const uint64_t* row(int id) const { return words.data() + (size_t)id * W; }
+    TermSetView view(int id) const { return TermSetView{ row(id), W }; }
+    size_t wordsPerSet() const { return W; }
+
+    int popcount(int id) const {
+        int n = 0;
+        for (size_t k = 0; k < W; ++k) n += __builtin_popcountll(row(id)[k]);
+        return n;
+    }
+
+    size_t size() const { return count; }
+    size_t bytes() const { return words.capacity() * sizeof(uint64_t) + slots.capacity() * sizeof(int); }
+
+private:
+    size_t W = 1;
+    vector<uint64_t> words;
+    vector<int> slots;  // 散列表，-1 为空
+    size_t count = 0;
+
+    size_t hashRow(const uint64_t* w) const {
+        uint64_t h = 0;
+        for (size_t k = 0; k < W; ++k) {
+            h = (h ^ w[k]) * 0x9E3779B97F4A7C15ull;
+            h ^= h >> 29;
+        }
+        return (size_t)h;
+    }
+
+    void grow() {
+        slots.assign(slots.size() * 2, -1);
+        size_t mask = slots.size() - 1;
+        for (size_t id = 0; id < count; ++id) {
+            size_t h = hashRow(row((int)id)) & mask;
+            while (slots[h] >= 0) h = (h + 1) & mask;
+            slots[h] = (int)id;
+        }
+    }
+};
+
+// 核心项目 -> 状态编号的散列索引。核心是按核心排序的扁平项目数组（向前看集合已换成池中的编号），
+// 以整个数组的 64 位 FNV-1a 散列定位，命中后再逐项比较，散列冲突不会把不同的状态当成同一个。
+// 同一个核心只登记第一个状态
+class KernelIndex {
+public:
+    void clear() {
+        kernels.clear();
+        states.clear();
+        hashes.clear();
+        slots.assign(1024, -1);
+    }
+
+    // 核心 K 的状态，没有时返回 -1
+    int find(const LR1ItemSet& K) const {
+        uint64_t h = hashKernel(K);
+        size_t mask = slots.size() - 1;
+        for (size_t s = h & mask; slots[s] >= 0; s = (s + 1) & mask) {
+            int e = slots[s];
+            if (hashes[e] == h && kernels[e] == K) return states[e];
+        }
+        return -1;
+    }
+
+    // 登记核心 K 的状态 j，K 已登记时不变
+    void insert(LR1ItemSet K, int j) {
+        if (find(K) >= 0) return;
+        if (2 * (kernels.size() + 1) > slots.size()) grow();
+        uint64_t h = hashKernel(K);
+        size_t mask = slots.size() - 1;
+        size_t s = h & mask;
+        while (slots[s] >= 0) s = (s + 1) & mask;
+        slots[s] = (int)kernels.size();
+        kernels.push_back(move(K));
+        states.push_back(j);
+        hashes.push_back(h);
+    }
+
+private:
+    vector<LR1ItemSet> kernels;
+    vector<int> states;
+    vector<uint64_t> hashes;
+    vector<int> slots;  // 散列表，-1 为空
+
+    static uint64_t hashKernel(const LR1ItemSet& K) {
+        static_assert(sizeof(LR1Item) == 3 * sizeof(int32_t), "LR1Item must be packed");
+        return fnv1a(K.data(), K.size() * sizeof(LR1Item));
+    }
+
+    void grow() {
+        slots.assign(slots.size() * 2, -1);
+        size_t mask = slots.size() - 1;
+        for (size_t e = 0; e < kernels.size(); ++e) {
+            size_t s = hashes[e] & mask;
+            while (slots[s] >= 0) s = (s + 1) & mask;
+            slots[s] = (int)e;
+        }
+    }
+};
+
+// 语法分析器类
+class LR1Parser {
+private:
+    Grammar G; // 文法（符号已编号），第一个产生式为拓广产生式 S' -> S
+
+    // First 和 Follow 集合（位集表示）
+    FirstFollow sets;
+
+    // 项目集规范族
+    vector<LR1ItemSet> C;
+    LookaheadPool lookaheads; // C 中项目的向前看集合
+
+    // closure 的工作区（跨调用复用）：核心、每个核心一行向前看位集、产生式下标 -> 点为 0 的核心
+    vector<pair<int, int>> closureCores;
+    vector<uint64_t> closureWords;
+    vector<int> closureSlot;
+    vector<int> closureWork;
+    vector<char> closureQueued;
+
+    // 分析表
+    // Action 表：状态 -> (终结符 -> Action)
+    // Action 的值为 "shift X", "reduce Y", "accept"
+    map<int, map<int, string>> Action;
+
+    // Goto 表：状态 -> (非终结符 -> 状态)
+    map<int, map<int, int>> GotoTable;
+
+    // recognize 用的稠密分析表，由 Action / GotoTable 导出（见 buildDenseTables），建表、读缓存与增删产生式之后重建。
+    // actionTable[状态 * numTerminals + a]：0 表示出错，j + 1 为移进到状态 j，-1 为接受，-2 - p 为按下标 p 的产生式归约；
+    // gotoTable[状态 * numNonTerminals + (X - numTerminals)]：目标状态，-1 表示没有表项
+    vector<int32_t> actionTable;
+    vector<int32_t> gotoTable;
+
+public:
+    // 读取文法规则
+    void readGrammar() {
+        ProfileScope prof("readGrammar");
+        G.read(cin, true); // EBNF 重复结构展开为左递归
+        if (G.numProductions() == 0) {
+            cerr << "Grammar has no productions.\n";
+            exit(1);
+        }
+
+        // 读取待分析的输入字符串（一整行，记号之间可以有空白）
+        getline(cin >> ws, inputString);
+    }
+
+    // 计算 First 集合
+    void computeFirst() {
+        ProfileScope prof("computeFirst");
+        sets.computeFirst(G);
+
+        // Debug: printFirstFollow();
+    }
+
+    // 计算 Follow 集合
+    void computeFollow() {
+        ProfileScope prof("computeFollow");
+        sets.computeFollow();
+
+        // Debug: printFirstFollow();
+    }
+
+    // 闭包操作：核心相同的项目合并，向前看集合沿“点在非终结符之前”的边传播，直到不再变化
+    LR1ItemSet closure(const LR1ItemSet& I) {
+        ProfileScope prof("closure");
+        size_t W = lookaheads.wordsPerSet();
+        closureCores.clear();
+        closureWords.clear();
+        closureWork.clear();
+        closureQueued.clear();
+        if (closureSlot.size() < (size_t)G.numProductions()) closureSlot.resize(G.numProductions(), -1);
+
+        auto addCore = [&](int prodId, int dot) {
+            int k = (int)closureCores.size();
+            closureCores.emplace_back(prodId, dot);
+            closureWords.resize(closureWords.size() + W, 0);
+            closureQueued.push_back(0);
+            if (dot == 0) closureSlot[prodId] = k;
+            return k;
+        };
+        for (auto& item : I) {
+            int k = addCore(item.prodId, item.dot);
+            copy(lookaheads.row(item.lookaheads), lookaheads.row(item.lookaheads) + W, closureWords.begin() + (size_t)k * W);
+            closureWork.push_back(k);
+            closureQueued[k] = 1;
+        }
+
+        vector<uint64_t> la(W);
+        while (!closureWork.empty()) {
+            int k = closureWork.back();
+            closureWork.pop_back();
+            closureQueued[k] = 0;
+            int prodId = closureCores[k].first, dot = closureCores[k].second;
+            if (dot >= G.rhsLength(prodId)) continue;
+            int B = G.rhsBegin(prodId)[dot];
+            if (!G.isNonTerminal(B)) continue;
+
+            // FIRST(β a)，β = rhs[dot+1 ... end]，a 取遍本项目的向前看集合：
+            // First(β) 直接查后缀表，β 可空时再并入整个向前看集合
+            TermSetView firstBeta = sets.suffixFirst(prodId, dot + 1);
+            const uint64_t* own = closureWords.data() + (size_t)k * W;
+            bool nullable = sets.suffixNullable(prodId, dot + 1);
+            for (size_t w = 0; w < W; ++w) la[w] = firstBeta.w[w] | (nullable ? own[w] : 0);
+
+            for (const int* p = G.altsBegin(B); p != G.altsEnd(B); ++p) {
+                int j = closureSlot[*p];
+                if (j < 0) j = addCore(*p, 0);
+                uint64_t* row = closureWords.data() + (size_t)j * W;
+                uint64_t diff = 0;
+                for (size_t w = 0; w < W; ++w) {
+                    diff |= la[w] & ~row[w];
+                    row[w] |= la[w];
+                }
+                if (diff != 0 && !closureQueued[j]) {
+                    closureQueued[j] = 1;
+                    closureWork.push_back(j);
+                }
+            }
+        }
+
+        // 按核心排序，向前看集合放入池中
+        vector<int> order(closureCores.size());
+        for (size_t k = 0; k < order.size(); ++k) order[k] = (int)k;
+        sort(order.begin(), order.end(), [&](int x, int y) { return closureCores[x] < closureCores[y]; });
+        LR1ItemSet closureSet;
+        closureSet.reserve(order.size());
+        for (int k : order) {
+            const uint64_t* row = closureWords.data() + (size_t)k * W;
+            if (closureCores[k].second == 0) closureSlot[closureCores[k].first] = -1;
+            if (all_of(row, row + W, [](uint64_t x) { return x == 0; })) continue;
+            closureSet.emplace_back(closureCores[k].first, closureCores[k].second, lookaheads.intern(row));
+        }
+        return closureSet;
+    }
+
+    // 迁移操作
+    LR1ItemSet goto_func(const LR1ItemSet& I, int X) {
+        ProfileScope prof("goto_func");
+        return closure(moveDot(I, X));
+    }
+
+    // goto 的核心项目：点在 X 之前的项目点右移一位（不求闭包），向前看集合不变，结果仍按核心有序
+    LR1ItemSet moveDot(const LR1ItemSet& I, int X) {
+        LR1ItemSet J;
+        for (auto& item : I) {
+            if (item.dot < G.rhsLength(item.prodId) && G.rhsBegin(item.prodId)[item.dot] == X) {
+                J.emplace_back(item.prodId, item.dot + 1, item.lookaheads);
+            }
+        }
+        return J;
+    }
+
+    // 构建项目集规范族。状态按核心项目去重：点不在最左的项目决定整个闭包（闭包只添加点在最左的项目），
+    // 所以 goto 只需先求核心，在散列索引中查找，核心是新的时才求闭包
+    void buildCanonicalCollection() {
+        ProfileScope prof("buildCanonicalCollection");
+        // 初始项集 C0 = closure({ S' -> . S, $ })
+        C.clear();
+        lookaheads.reset(G.numTerminals);
+        LR1ItemSet C0;
+        // 生产式 1: S' -> E
+        C0.emplace_back(0, 0, lookaheads.singleton(G.endMarker));
+        C.push_back(closure(C0));
+        PARSER_PROBE2(lr1, state, 0, (int)C[0].size());
+        KernelIndex byKernel;
+        byKernel.clear();
+        byKernel.insert(move(C0), 0);
+
+        // 按名字排序的符号序列，保证状态编号与按字符串排序时一致
+        vector<int> byName = G.symbolsByName();
+        vector<char> seen(G.numSymbols());
+
+        // 使用 BFS 构建项目集
+        queue<int> q;
+        q.push(0);
+
+        while (!q.empty()) {
+            int i = q.front();
+            q.pop();
+            fill(seen.begin(), seen.end(), 0);
+            for (auto& item : C[i]) {
+                if (item.dot < G.rhsLength(item.prodId)) {
+                    seen[G.rhsBegin(item.prodId)[item.dot]] = 1;
+                }
+            }
+
+            for (int X : byName) {
+                if (!seen[X]) continue;
+                LR1ItemSet J = moveDot(C[i], X);
+                if (J.empty()) continue;
+
+                int j = byKernel.find(J);
+                if (j == -1) {
+                    j = (int)C.size();
+                    C.push_back(closure(J));
+                    byKernel.insert(move(J), j);
+                    PARSER_PROBE2(lr1, state, j, (int)C[j].size());
+                    q.push(j);
+                }
+
+                // 填充 Action 和 Goto 表
+                if (G.isTerminal(X)) {
+                    Action[i][X] = "shift " + to_string(j);
+                }
+                else {
+                    GotoTable[i][X] = j;
+                }
+            }
+        }
+    }
+
+    // 构建分析表。移进的目标状态取自 buildCanonicalCollection 记下的转移：
+    // 处理状态 i 之前，Action[i] 中只有移进表项，先记下再按项目顺序重填
+    void buildParseTable() {
+        ProfileScope prof("buildParseTable");
+        vector<int> target(G.numTerminals, -1);
+        for (int i = 0; i < (int)C.size(); ++i) {
+            auto row = Action.find(i);
+            if (row != Action.end()) {
+                for (auto& e : row->second) {
+                    if (e.second.compare(0, 6, "shift ") == 0) target[e.first] = stoi(e.second.substr(6));
+                }
+            }
+            for (auto& item : C[i]) {
+                if (item.dot < G.rhsLength(item.prodId)) {
+                    int a = G.rhsBegin(item.prodId)[item.dot];
+                    if (G.isTerminal(a)) {
+                        Action[i][a] = "shift " + to_string(target[a]);
+                    }
+                }
+                else {
+                    lookaheads.view(item.lookaheads).forEach([&](int la) {
+                        if (G.prodLhs[item.prodId] != G.prodLhs[0]) {
+                            // A -> α ., a
+                            // Action[i, a] = reduce prod.id
+                            Action[i][la] = "reduce " + to_string(G.prodNumber[item.prodId]);
+                        }
+                        else {
+                            // S' -> S ., $
+                            if (la == G.endMarker) {
+                                Action[i][la] = "accept";
+                            }
+                        }
+                    });
+                }
+            }
+        }
+        buildDenseTables();
+    }
+
+    // 由 Action / GotoTable 生成稠密分析表，分析时不再查 map、解析表项字符串
+    void buildDenseTables() {
+        int T = G.numTerminals, N = G.numNonTerminals();
+        actionTable.assign(C.size() * T, 0);
+        gotoTable.assign(C.size() * N, -1);
+        for (auto& row : Action) {
+            int32_t* r = actionTable.data() + (size_t)row.first * T;
+            for (auto& e : row.second) {
+                const string& action = e.second;
+                if (action[0] == 's') r[e.first] = stoi(action.substr(6)) + 1;
+                else if (action[0] == 'r') r[e.first] = -2 - G.productionIndex(stoi(action.substr(7)));
+                else r[e.first] = -1;
+            }
+        }
+        for (auto& row : GotoTable) {
+            int32_t* r = gotoTable.data() + (size_t)row.first * N;
+            for (auto& e : row.second) r[e.first - T] = e.second;
+        }
+    }
+
+    // 从磁盘缓存读取项目集规范族与分析表（见 table_cache.h），文法与缓存一致时返回 true。
+    // 缓存中各表都是扁平数组，读入只是线性地重建容器，不再求闭包与 goto
+    bool loadTables() {
+        ProfileScope prof("loadTables");
+        vector<int32_t> key = grammarKey(G);
+        TableCache cache;
+        if (!cache.open(tableCachePath(kCacheLR1, key), kCacheLR1, key) || cache.sections() != 5) return false;
+
+        // 第 1、2 节：每个状态的项目区间，项目为 (产生式下标, 点的位置, 向前看符号) 三元组，
+        // 按 (产生式下标, 点的位置, 向前看符号) 排序；同一核心的三元组合并成一个项目
+        const int32_t* offset = cache.section(1);
+        const int32_t* items = cache.section(2);
+        size_t n = cache.sectionSize(1);
+        if (n == 0 || offset[0] != 0 || (size_t)offset[n - 1] * 3 != cache.sectionSize(2)) return false;
+        lookaheads.reset(G.numTerminals);
+        vector<LR1ItemSet> states(n - 1);
+        TermSet row(G.numTerminals);
+        for (size_t i = 0; i + 1 < n; ++i) {
+            if (offset[i + 1] < offset[i]) return false;
+            for (int k = offset[i]; k < offset[i + 1]; ++k) {
+                const int32_t* it = items + 3 * (size_t)k;
+                if (it[0] < 0 || it[0] >= G.numProductions() || it[1] < 0 || it[1] > G.rhsLength(it[0])
+                    || !G.isTerminal(it[2])) return false;
+                row.set(it[2]);
+                const int32_t* nx = it + 3;
+                if (k + 1 < offset[i + 1] && nx[0] == it[0] && nx[1] == it[1]) continue;
+                if (!states[i].empty() && make_pair(it[0], it[1]) <= make_pair(states[i].back().prodId, states[i].back().dot)) return false;
+                states[i].emplace_back(it[0], it[1], lookaheads.intern(row.data()));
+                row.clear();
+            }
+        }
+
+        // 第 3 节：(状态, 终结符, 种类, 值)，种类 0 为移进（值为状态），1 为归约（值为产生式编号），2 为接受
+        // 第 4 节：(状态, 非终结符, 状态)
+        const int32_t* act = cache.section(3);
+        const int32_t* go = cache.section(4);
+        // 与项目一样先逐项检查：状态与移进、转移的目标须是已读入的状态，归约的产生式编号须存在
+        size_t na = cache.sectionSize(3), ng = cache.sectionSize(4);
+        int numStates = (int)states.size();
+        if (na % 4 != 0 || ng % 3 != 0) return false;
+        for (size_t k = 0; k < na; k += 4) {
+            if (act[k] < 0 || act[k] >= numStates || !G.isTerminal(act[k + 1])) return false;
+            if (act[k + 2] == 0) {
+                if (act[k + 3] < 0 || act[k + 3] >= numStates) return false;
+            } else if (act[k + 2] == 1) {
+                if (G.productionIndex(act[k + 3]) < 0) return false;
+            } else if (act[k + 2] != 2) {
+                return false;
+            }
+        }
+        for (size_t k = 0; k < ng; k += 3) {
+            if (go[k] < 0 || go[k] >= numStates || !G.isNonTerminal(go[k + 1])
+                || go[k + 2] < 0 || go[k + 2] >= numStates) return false;
+        }
+        Action.clear();
+        GotoTable.clear();
+        for (size_t k = 0; k < na; k += 4) {
+            string& cell = Action[act[k]][act[k + 1]];
+            if (act[k + 2] == 0) cell = "shift " + to_string(act[k + 3]);
+            else if (act[k + 2] == 1) cell = "reduce " + to_string(act[k + 3]);
+            else cell = "accept";
+        }
+        for (size_t k = 0; k < ng; k += 3) {
+            GotoTable[go[k]][go[k + 1]] = go[k + 2];
+        }
+        C.swap(states);
+        buildDenseTables();
+        return true;
+    }
+
+    // 把项目集规范族与分析表写入磁盘缓存（未启用缓存时什么也不做）
+    void saveTables() {
+        vector<vector<int32_t>> sections(5);
+        sections[0] = grammarKey(G);
+        string path = tableCachePath(kCacheLR1, sections[0]);
+        if (path.empty()) return;
+        sections[1].push_back(0);
+        for (auto& I : C) {
+            for (auto& item : I) {
+                lookaheads.view(item.lookaheads).forEach([&](int la) {
+                    sections[2].push_back(item.prodId);
+                    sections[2].push_back(item.dot);
+                    sections[2].push_back(la);
+                });
+            }
+            sections[1].push_back((int32_t)(sections[2].size() / 3));
+        }
+        for (auto& row : Action) {
+            for (auto& e : row.second) {
+                int kind = e.second == "accept" ? 2 : e.second.compare(0, 5, "shift") == 0 ? 0 : 1;
+                sections[3].push_back(row.first);
+                sections[3].push_back(e.first);
+                sections[3].push_back(kind);
+                sections[3].push_back(kind == 2 ? 0 : stoi(e.second.substr(kind == 0 ? 6 : 7)));
+            }
+        }
+        for (auto& row : GotoTable) {
+            for (auto& e : row.second) {
+                sections[4].push_back(row.first);
+                sections[4].push_back(e.first);
+                sections[4].push_back(e.second);
+            }
+        }
+        if (!writeTableCache(path, kCacheLR1, sections)) {
+            cerr << "Cannot write parse table cache " << path << endl;
+        }
+    }
+
+    // 增加产生式（形如 "A -> x y"），只重建受影响的项目集并原地修改分析表（化简结果有变化时重新建表，见 syncWithDeclared）
+    bool addProduction(const string& line) {
+        int A;
+        vector<int> body;
+        string err;
+        if (!declared.parseProduction(line, A, body, err)) {
+            cerr << "Cannot add production: " << err << endl;
+            return false;
+        }
+        if (A == declared.prodLhs[0]) {
+            cerr << "Cannot add production: " << declared.names[A] << " is the augmented start symbol" << endl;
+            return false;
+        }
+        int q = declared.addProduction(A, body);
+        cout << "\nAdded production " << declared.prodNumber[q] << ": " << declared.names[A] << " -> ";
+        declared.printRhs(cout, q);
+        cout << "\n";
+        // 用到了化简去掉的符号时 G 中没有这些符号，直接由 declared 重新建表
+        if (G.parseProduction(line, A, body, err)) {
+            int p = G.addProduction(A, body, declared.prodNumber[q]);
+            if (!syncWithDeclared()) updateCollection(A, sets.update(A, body, p), -1);
+        }
+        else {
+            syncWithDeclared();
+        }
+        return true;
+    }
+
+    // 删除输入序号为 number 的产生式（拓广产生式除外）
+    bool removeProduction(int number) {
+        int q = declared.productionIndex(number);
+        if (q <= 0 || declared.isLoop(declared.prodLhs[q]) || declared.prodLhs[q] == declared.prodLhs[0]) {
+            cerr << "Cannot remove production " << number << endl;
+            return false;
+        }
+        declared.removeProduction(q);
+        cout << "\nRemoved production " << number << "\n";
+        // 化简时已去掉的产生式不在 G 中，直接由 declared 重新建表
+        int p = G.productionIndex(number);
+        if (p >= 0) {
+            int A = G.prodLhs[p];
+            vector<int> body(G.rhsBegin(p), G.rhsEnd(p));
+            sets.eraseSuffixRows(p);
+            G.removeProduction(p);
+            if (!syncWithDeclared()) updateCollection(A, sets.update(A, body), p);
+        }
+        else {
+            syncWithDeclared();
+        }
+        return true;
+    }
+
+    // 增删左部为 A 的产生式之后更新项目集规范族（removed 为被删产生式原来的下标，增加时为 -1）。
+    // 状态的闭包只取决于核心项目、所预测的非终结符的候选式以及后缀的 First 集合，
+    // 因此只有闭包中点在 A 之前、或所在产生式的后缀行有变化的状态需要重新求闭包；
+    // 其余状态连同它们的 Action / Goto 行原样保留。从状态 0 出发按核心项目重新连接，
+    // 新出现的项目集追加在末尾，不再可达的状态置空（编号不复用）。
+    void updateCollection(int A, const FirstFollowDelta& d, int removed) {
+        int n = (int)C.size();
+        vector<char> affected(n, 0), stale(n, 0);
+
+        // 删除产生式后其后产生式的下标减一；含被删产生式项目的状态必须重建，
+        // 核心中含有它的状态不会再出现
+        if (removed >= 0) {
+            for (int i = 0; i < n; ++i) {
+                LR1ItemSet I;
+                for (auto item : C[i]) {
+                    if (item.prodId == removed) {
+                        affected[i] = 1;
+                        if (item.dot > 0) stale[i] = 1;
+                        continue;
+                    }
+                    if (item.prodId > removed) item.prodId--;
+                    I.push_back(item);
+                }
+                C[i].swap(I);
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            for (auto& item : C[i]) {
+                if (item.dot >= G.rhsLength(item.prodId)) continue;
+                int X = G.rhsBegin(item.prodId)[item.dot];
+                if (X == A || (G.isNonTerminal(X) && d.prodTouched[item.prodId])) {
+                    affected[i] = 1;
+                    break;
+                }
+            }
+        }
+
+        // 核心项目 -> 状态
+        KernelIndex byKernel;
+        byKernel.clear();
+        int endOnly = lookaheads.singleton(G.endMarker);
+        auto kernelOf = [&](int i) {
+            LR1ItemSet K;
+            if (i == 0) K.emplace_back(0, 0, endOnly);
+            for (auto& item : C[i]) {
+                if (item.dot > 0) K.push_back(item);
+            }
+            return K;
+        };
+        for (int i = 0; i < n; ++i) {
+            if (!C[i].empty() && !stale[i]) byKernel.insert(kernelOf(i), i);
+        }
+
+        vector<int> byName = G.symbolsByName();
+        vector<char> seen(G.numSymbols());
+        vector<int> target(G.numSymbols());
+        vector<char> visited(n, 0);
+        queue<int> q;
+        q.push(0);
+        visited[0] = 1;
+        auto reach = [&](int j) {
+            if (j >= (int)visited.size()) visited.resize(j + 1, 0);
+            if (!visited[j]) {
+                visited[j] = 1;
+                q.push(j);
+            }
+        };
+
+        while (!q.empty()) {
+            int i = q.front();
+            q.pop();
+            // 未受影响的状态闭包不变、表行不变，只需沿转移继续（转移目标仍按核心查找，
+            // 因为有冲突时移进表项可能已被归约覆盖）
+            bool rebuild = i >= n || affected[i];
+            if (i < n && affected[i]) C[i] = closure(kernelOf(i));
+
+            // 求转移，目标按核心项目查找，找不到时新建状态
+            fill(seen.begin(), seen.end(), 0);
+            for (auto& item : C[i]) {
+                if (item.dot < G.rhsLength(item.prodId)) {
+                    seen[G.rhsBegin(item.prodId)[item.dot]] = 1;
+                }
+            }
+            if (rebuild) {
+                Action.erase(i);
+                GotoTable.erase(i);
+            }
+            for (int X : byName) {
+                if (!seen[X]) continue;
+                LR1ItemSet J = moveDot(C[i], X);
+                int j = byKernel.find(J);
+                if (j == -1) {
+                    j = (int)C.size();
+                    C.push_back(closure(J));
+                    byKernel.insert(J, j);
+                    PARSER_PROBE2(lr1, state, j, (int)C[j].size());
+                }
+                target[X] = j;
+                reach(j);
+                if (!rebuild) continue;
+                if (G.isTerminal(X)) Action[i][X] = "shift " + to_string(j);
+                else GotoTable[i][X] = j;
+            }
+            if (!rebuild) continue;
+
+            // 与 buildParseTable 相同：按项目顺序填写移进、归约与接受
+            for (auto& item : C[i]) {
+                if (item.dot < G.rhsLength(item.prodId)) {
+                    int a = G.rhsBegin(item.prodId)[item.dot];
+                    if (G.isTerminal(a)) Action[i][a] = "shift " + to_string(target[a]);
+                }
+                else {
+                    lookaheads.view(item.lookaheads).forEach([&](int la) {
+                        if (G.prodLhs[item.prodId] != G.prodLhs[0]) {
+                            Action[i][la] = "reduce " + to_string(G.prodNumber[item.prodId]);
+                        }
+                        else if (la == G.endMarker) {
+                            Action[i][la] = "accept";
+                        }
+                    });
+                }
+            }
+        }
+
+        // 不再可达的旧状态
+        for (int i = 0; i < n; ++i) {
+            if (visited[i]) continue;
+            C[i].clear();
+            Action.erase(i);
+            GotoTable.erase(i);
+        }
+        buildDenseTables(); // 增删产生式会移动产生式下标，整表重建
+    }
+
+    // 解析输入字符串并输出分析过程
+    void parseInput() {
+        ProfileScope prof("parseInput");
+        // 分词：按声明的终结符做最长匹配（见 tokenizer.h），不属于任何终结符的字节记为未知记号
+        vector<int> inputTokens = tokenize(inputString);
+        inputTokens.push_back(G.endMarker); // 末尾加入 $
+
+        // 初始化解析栈
+        vector<int> parseStack;
+        parseStack.push_back(0);
+
+        int ip = 0; // 输入指针
+        bool accept = false;
+
+        // 存储输出动作
+        vector<string> actions;
+
+        while (true) {
+            int state = parseStack.back();
+            int a = inputTokens[ip];
+
+            // 查找 Action[state][a]
+            auto row = Action.find(state);
+            if (row != Action.end() && row->second.count(a)) {
+                string action = row->second[a];
+                if (action.substr(0, 5) == "shift") {
+                    actions.push_back("shift");
+                    // 获取状态 j
+                    int j = stoi(action.substr(6));
+                    PARSER_PROBE3(lr1, shift, state, a, j);
+                    parseStack.push_back(j);
+                    ip++;
+                }
+                else if (action.substr(0, 6) == "reduce") {
+                    // 获取生产式编号
+                    int prodId = stoi(action.substr(7));
+                    PARSER_PROBE2(lr1, reduce, state, prodId);
+                    actions.push_back(to_string(prodId-1));
+                    // 注意：prodId 是从1开始的输入序号，化简后不一定连续
+                    int p = G.productionIndex(prodId);
+                    if (p < 0) {
+                        cerr << "Error: Invalid production ID " << prodId << ".\n";
+                        break;
+                    }
+                    int A = G.prodLhs[p];
+
+                    // 弹出 rhs.size() 个状态
+                    for (int k = 0; k < G.rhsLength(p); ++k) {
+                        if (!parseStack.empty())
+                            parseStack.pop_back();
+                        else {
+                            cerr << "Error: Stack underflow during reduction.\n";
+                            break;
+                        }
+                    }
+                    // 获取当前状态
+                    if (parseStack.empty()) {
+                        cerr << "Error: Stack is empty after reduction.\n";
+                        break;
+                    }
+                    int currentState = parseStack.back();
+                    // Goto[currentState][A] = j
+                    auto gotoRow = GotoTable.find(currentState);
+                    if (gotoRow != GotoTable.end() && gotoRow->second.count(A)) {
+                        int j = gotoRow->second[A];
+                        parseStack.push_back(j);
+                    }
+                    else {
+                        cerr << "Error: Goto table entry not found for state " << currentState << " and non-terminal " << G.names[A] << ".\n";
+                        break;
+                    }
+                }
+                else if (action == "accept") {
+                    PARSER_PROBE1(lr1, accept, state);
+                    actions.push_back("accept");
+                    accept = true;
+                    break;
+                }
+            }
+            else {
+                // 查找 Action[state][a] 不存在，解析错误
+                actions.push_back("error");
+                break;
+            }
+        }
+
+        // 输出动作
+        cout << "Parsing Actions:\n";
+        for (auto& act : actions) {
+            cout << act << "\n";
+        }
+
+        if (accept) {
+            cout << "Parsing accepted.\n";
+        }
+        else {
+            cout << "Parsing failed.\n";
+        }
+    }
+
+    // 辅助函数：判断是否是非终结符
+    bool isNonTerminal(const string& sym) {
+        return G.isNonTerminal(G.lookup(sym));
+    }
+
+    // 分词函数：按终结符最长匹配（见 tokenizer.h），不是终结符的字符记为 -1
+    vector<int> tokenize(const string& input) {
+        if (!lexer.built()) lexer.build(G);
+        return lexer.tokenize(input);
+    }
+
+    // 打印项目集规范族（调试用）
+    void printCanonicalCollection() {
+        cout << "\nCanonical Collection of LR(1) Items:\n";
+        for (int i = 0; i < (int)C.size(); ++i) {
+            if (C[i].empty()) continue;
+            cout << "C" << i << ":\n";
+            for (auto& item : C[i]) {
+                const int* rhs = G.rhsBegin(item.prodId);
+                int len = G.rhsLength(item.prodId);
+                lookaheads.view(item.lookaheads).forEach([&](int la) {
+                    cout << "  " << G.names[G.prodLhs[item.prodId]] << " -> ";
+                    for (int j = 0; j < len; ++j) {
+                        if (j == item.dot)
+                            cout << ". ";
+                        cout << G.names[rhs[j]] << " ";
+                    }
+                    if (item.dot == len)
+                        cout << ". ";
+                    cout << ", " << G.names[la] << "\n";
+                });
+            }
+            cout << "\n";
+        }
+    }
+
+    // 打印 First 和 Follow 集合（调试用）
+    void printFirstFollow() {
+        sets.printFirst(cout);
+        sets.printFollow(cout);
+    }
+
+    // 打印分析表（改进版）
+    void printParseTable() {
+        ProfileScope prof("printParseTable");
+        // 打印 Action 表
+        cout << "\nAction Table:\n";
+
+        // 收集所有终结符（$ 放在最后）
+        vector<int> termList;
+        for (int t = 0; t < G.numTerminals; ++t) {
+            if (t != G.epsilon && t != G.endMarker) // 'e' 作为特殊符号单独处理
+                termList.push_back(t);
+        }
+        termList.push_back(G.endMarker); // 添加结束符
+
+        // 打印表头
+        cout << "State\t";
+        for (int term : termList) {
+            cout << G.names[term] << "\t";
+        }
+        cout << "\n";
+
+        // 打印每个状态的 Action 表项（跳过增量修改后不再可达的空状态）
+        for (int i = 0; i < (int)C.size(); ++i) {
+            if (C[i].empty()) continue;
+            cout << i << "\t";
+            auto row = Action.find(i);
+            for (int term : termList) {
+                if (row != Action.end() && row->second.count(term)) {
+                    cout << row->second[term] << "\t";
+                }
+                else {
+                    cout << "\t";
+                }
+            }
+            cout << "\n";
+        }
+
+        // 打印 Goto 表
+        cout << "\nGoto Table:\n";
+
+        // 打印表头
+        cout << "State\t";
+        for (int nt = G.numTerminals; nt < G.numSymbols(); ++nt) {
+            cout << G.names[nt] << "\t";
+        }
+        cout << "\n";
+
+        // 打印每个状态的 Goto 表项
+        for (int i = 0; i < (int)C.size(); ++i) {
+            if (C[i].empty()) continue;
+            cout << i << "\t";
+            auto row = GotoTable.find(i);
+            for (int nt = G.numTerminals; nt < G.numSymbols(); ++nt) {
+                if (row != GotoTable.end() && row->second.count(nt)) {
+                    cout << row->second[nt] << "\t";
+                }
+                else {
+                    cout << "\t";
+                }
+            }
+            cout << "\n";
+        }
+    }
+
+    // 以下供其他驱动程序使用（不输出分析过程）
+
+    // 从 in 读取文法并化简（不含待分析的输入串），化简报告写到 log
+    void loadGrammar(istream& in, ostream& log) {
+        G.read(in, true);
+        if (G.numProductions() == 0) {
+            cerr << "Grammar has no productions.\n";
+            exit(1);
+        }
+        reduce(log);
+    }
+
+    // 计算 First / Follow，构造项目集规范族与分析表
+    void buildTables() {
+        sets.computeFirst(G);
+        sets.computeFollow();
+        buildCanonicalCollection();
+        buildParseTable();
+    }
+
+    const Grammar& grammar() const { return G; }
+
+    int numStates() const { return (int)C.size(); }
+
+    size_t tableEntries() const {
+        size_t n = 0;
+        for (auto& row : Action) n += row.second.size();
+        for (auto& row : GotoTable) n += row.second.size();
+        return n;
+    }
+
+    // 判断终结符编号序列（不含末尾的 $）能否被接受；trace 非空时记录依次归约所用的产生式编号。
+    // 只读分析表，每次调用使用自己的分析栈，多个线程可以同时调用（见 batch.cpp）
+    bool recognize(const vector<int>& tokens, vector<int>* trace = nullptr) const {
+        size_t ip = 0;
+        return recognize([&]() { return ip < tokens.size() ? tokens[ip++] : G.endMarker; }, trace);
+    }
+
+    // 流式版本：每次调用 next() 取下一个终结符编号，输入结束后返回 $；
+    // 记号一个个到来时即可分析（见 pipeline.cpp），不需要先收齐整个序列
+    template <typename Next>
+    bool recognize(Next next, vector<int>* trace = nullptr) const {
+        int T = G.numTerminals, N = G.numNonTerminals();
+        vector<int> parseStack;
+        parseStack.push_back(0);
+        int a = next();
+        while (true) {
+            if (a < 0 || a >= T) return false; // 未知记号
+            int32_t action = actionTable[(size_t)parseStack.back() * T + a];
+            if (action > 0) {
+                int j = action - 1;
+                PARSER_PROBE3(lr1, shift, parseStack.back(), a, j);
+                parseStack.push_back(j);
+                a = next();
+            }
+            else if (action < -1) {
+                int p = -2 - action;
+                int number = G.prodNumber[p];
+                PARSER_PROBE2(lr1, reduce, parseStack.back(), number);
+                if (trace) trace->push_back(number);
+                parseStack.resize(parseStack.size() - G.rhsLength(p));
+                int target = gotoTable[(size_t)parseStack.back() * N + (G.prodLhs[p] - T)];
+                if (target < 0) return false;
+                parseStack.push_back(target);
+            }
+            else if (action == 0) {
+                return false;
+            }
+            else {
+                PARSER_PROBE1(lr1, accept, parseStack.back());
+                return true;
+            }
+        }
+    }
+
+    // 运行解析器
+    void run() {
+        readGrammar();
+        {
+            ProfileScope prof("reduceGrammar");
+            reduce(cerr); // 去掉无用符号与产生式
+        }
+        computeFirst();
+        computeFollow();
+        bool cached = loadTables();
+        if (!cached) {
+            buildCanonicalCollection();
+            buildParseTable();
+            saveTables();
+        }
+        printParseTable(); // 输出解析表
+        parseInput();
+        editGrammar();
+        reportProfile(cached);
+    }
+
+    // 输出 profile 报告（见 profile.h），未启用时什么也不做
+    void reportProfile(bool cached) {
+        Profiler& prof = profiler();
+        if (!prof.enabled()) return;
+        // items 按 (产生式, 点, 向前看符号) 三元组计，item_cores 为合并后的项目数
+        size_t states = 0, items = 0, cores = 0, minItems = 0, maxItems = 0;
+        size_t bytesC = C.capacity() * sizeof(LR1ItemSet) + lookaheads.bytes();
+        for (auto& I : C) {
+            if (I.empty()) continue;
+            size_t k = 0;
+            for (auto& item : I) k += lookaheads.popcount(item.lookaheads);
+            minItems = states == 0 ? k : min(minItems, k);
+            maxItems = max(maxItems, k);
+            states++;
+            items += k;
+            cores += I.size();
+            bytesC += I.capacity() * sizeof(LR1Item);
+        }
+        prof.stat("symbols", G.numSymbols());
+        prof.stat("productions", G.numProductions());
+        prof.stat("item_sets", (double)states);
+        prof.stat("items", (double)items);
+        prof.stat("item_cores", (double)cores);
+        prof.stat("lookahead_sets", (double)lookaheads.size());
+        prof.stat("items_per_set_min", (double)minItems);
+        prof.stat("items_per_set_max", (double)maxItems);
+        prof.stat("items_per_set_mean", states ? (double)items / states : 0);
+        prof.stat("cache_hit", cached);
+        prof.stat("bytes_C", (double)bytesC);
+        prof.stat("bytes_Action", (double)mapBytes(Action));
+        prof.stat("bytes_GotoTable", (double)mapBytes(GotoTable));
+        prof.stat("bytes_denseTables", (double)((actionTable.size() + gotoTable.size()) * sizeof(int32_t)));
+        prof.stat("bytes_First", (double)sets.setBytes(sets.first));
+        prof.stat("bytes_Follow", (double)sets.setBytes(sets.follow));
+        prof.stat("bytes_suffixFirst", (double)sets.suffixBytes());
+        vector<int32_t> key = grammarKey(G);
+        prof.report("lr1", fnv1a(key.data(), key.size() * sizeof(int32_t)));
+    }
+
+    // 读入之后的修改命令，每行一条：
+    //   add A -> x y    增加产生式
+    //   remove N        删除输入序号为 N 的产生式
+    //   parse s         用当前的分析表分析输入串 s
+    //   print           输出当前的分析表
+    void editGrammar() {
+        string line;
+        while (getline(cin, line)) {
+            istringstream in(line);
+            string cmd;
+            if (!(in >> cmd)) continue;
+            if (cmd == "add") {
+                string rest;
+                getline(in, rest);
+                addProduction(rest);
+            }
+            else if (cmd == "remove") {
+                int number;
+                if (in >> number) removeProduction(number);
+                else cerr << "Usage: remove N" << endl;
+            }
+            else if (cmd == "parse") {
+                getline(in >> ws, inputString);
+                parseInput();
+            }
+            else if (cmd == "print") {
+                printParseTable();
+            }
+            else {
+                cerr << "Unknown command: " << cmd << endl;
+            }
+        }
+    }
+
+private:
+    string inputString; // 待分析的输入字符串
+    Tokenizer lexer;    // 由终结符集合构造的分词器
+
+    // 化简前的文法（含此后的修改）。化简去掉的符号与产生式在修改之后可能重新有用（增加的产生式用到被去掉的终结符，
+    // 或使不可达的非终结符重新可达），修改也可能使原本有用的部分变得无用、使候选式重复，
+    // 所以每次修改同时记在 declared 上并重新化简：结果与增量修改后的 G 相同时照常增量更新，否则换成化简结果并重新建表
+    Grammar declared;
+
+    // 化简文法，被去掉的内容写到 log
+    void reduce(ostream& log) {
+        declared = G;
+        reduceGrammar(G, log);
+    }
+
+    // 修改之后 declared 的化简结果与 G 不同时，换成化简结果并重新建表
+    bool syncWithDeclared() {
+        Grammar reduced = declared;
+        ostringstream log;
+        reduceGrammar(reduced, log);
+        if (grammarKey(reduced) == grammarKey(G)) return false;
+        cerr << log.str();
+        G = move(reduced);
+        lexer = Tokenizer();
+        Action.clear();
+        GotoTable.clear();
+        sets.computeFirst(G);
+        sets.computeFollow();
+        buildCanonicalCollection();
+        buildParseTable();
+        return true;
+    }
+};
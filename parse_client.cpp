@@ -0,0 +1,67 @@
+﻿// 常驻分析服务的示例客户端
+//
+// 编译：g++ -O2 -std=c++17 parse_client.cpp -o parse_client
+// 用法：parse_client [--socket 路径] [--repeat N] 文法名 < 输入
+//
+// 标准输入每行一个待分析的串，逐个发送给 parse_server，每行输出一个结果：
+//   accept|reject|unknown-grammar|bad-request\t<产生式编号序列>
+// --repeat N 时每个串重复发送 N 次（只输出一次），用于测量往返延迟；
+// 请求数与平均往返时间写到标准错误。
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "parse_protocol.h"
+using namespace std;
+
+int main(int argc, char** argv) {
+    string socketPath = "/tmp/parse_server.sock", grammar;
+    long repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--socket") && i + 1 < argc) socketPath = argv[++i];
+        else if (!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = max(1L, atol(argv[++i]));
+        else grammar = argv[i];
+    }
+    if (grammar.empty() || grammar.size() > 255) {
+        cerr << "Usage: parse_client [--socket PATH] [--repeat N] GRAMMAR < inputs" << endl;
+        return 2;
+    }
+
+    sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (!unixAddress(socketPath, addr) || fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        perror(socketPath.c_str());
+        return 1;
+    }
+
+    const char* statusNames[] = { "accept", "reject", "unknown-grammar", "bad-request" };
+    string line, payload;
+    vector<int> trace;
+    long requests = 0;
+    double seconds = 0;
+    while (getline(cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        string request = encodeRequest(grammar, line);
+        uint8_t status = kParseBadRequest;
+        auto start = chrono::steady_clock::now();
+        for (long r = 0; r < repeat; ++r) {
+            if (!writeFrame(fd, request) || !readFrame(fd, payload) || !decodeResponse(payload, status, trace)) {
+                cerr << "Connection to server lost" << endl;
+                return 1;
+            }
+        }
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        requests += repeat;
+
+        cout << (status <= kParseBadRequest ? statusNames[status] : "error") << "\t";
+        for (size_t k = 0; k < trace.size(); ++k) cout << (k ? " " : "") << trace[k];
+        cout << "\n";
+    }
+    close(fd);
+    if (requests > 0) {
+        cerr << requests << " requests, " << seconds / requests * 1e6 << " us per round trip" << endl;
+    }
+    return 0;
+}
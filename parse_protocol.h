@@ -0,0 +1,113 @@
+﻿// 常驻分析服务（parse_server.cpp）的帧协议，客户端与服务端共用
+//
+// 通过 Unix 域套接字通信，只在本机使用，整数一律为本机字节序。每帧前是 4 字节的负载长度：
+//   请求  u32 长度 | u8 文法名长度 | 文法名 | 输入串（其余字节）
+//   应答  u32 长度 | u8 状态 | u32 个数 n | n 个 i32 产生式编号
+// 状态：0 接受，1 拒绝，2 未知文法，3 请求格式错误。产生式编号序列同 recognize 的 trace
+// （LL 为推导顺序，LR 为归约顺序），拒绝时是出错前已使用的部分。
+// 一个连接上可以连续发送多个请求，应答按请求顺序返回。
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+enum ParseStatus : uint8_t { kParseAccept = 0, kParseReject = 1, kParseUnknownGrammar = 2, kParseBadRequest = 3 };
+
+const uint32_t kMaxFrame = 64u << 20; // 单帧上限，防止错误的长度字段耗尽内存
+
+inline bool readFully(int fd, void* buf, size_t n) {
+    char* p = (char*)buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+inline bool writeFully(int fd, const void* buf, size_t n) {
+    const char* p = (const char*)buf;
+    while (n > 0) {
+        ssize_t r = send(fd, p, n, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+// 读一帧负载；连接关闭或长度超限时返回 false
+inline bool readFrame(int fd, string& payload) {
+    uint32_t len;
+    if (!readFully(fd, &len, sizeof(len)) || len > kMaxFrame) return false;
+    payload.resize(len);
+    return len == 0 || readFully(fd, &payload[0], len);
+}
+
+// 写一帧：长度与负载一次发送
+inline bool writeFrame(int fd, const string& payload) {
+    string frame(sizeof(uint32_t), '\0');
+    uint32_t len = (uint32_t)payload.size();
+    memcpy(&frame[0], &len, sizeof(len));
+    frame += payload;
+    return writeFully(fd, frame.data(), frame.size());
+}
+
+inline string encodeRequest(const string& grammar, const string& input) {
+    string s(1, (char)(uint8_t)grammar.size());
+    return s + grammar + input;
+}
+
+inline bool decodeRequest(const string& payload, string& grammar, string& input) {
+    if (payload.empty() || payload.size() < 1 + (size_t)(uint8_t)payload[0]) return false;
+    size_t n = (uint8_t)payload[0];
+    grammar.assign(payload, 1, n);
+    input.assign(payload, 1 + n, string::npos);
+    return true;
+}
+
+inline string encodeResponse(uint8_t status, const vector<int>& trace) {
+    string s(1 + sizeof(uint32_t) + trace.size() * sizeof(int32_t), '\0');
+    s[0] = (char)status;
+    uint32_t n = (uint32_t)trace.size();
+    memcpy(&s[1], &n, sizeof(n));
+    for (size_t i = 0; i < trace.size(); ++i) {
+        int32_t v = trace[i];
+        memcpy(&s[1 + sizeof(n) + i * sizeof(v)], &v, sizeof(v));
+    }
+    return s;
+}
+
+inline bool decodeResponse(const string& payload, uint8_t& status, vector<int>& trace) {
+    uint32_t n;
+    if (payload.size() < 1 + sizeof(n)) return false;
+    status = (uint8_t)payload[0];
+    memcpy(&n, &payload[1], sizeof(n));
+    if (payload.size() != 1 + sizeof(n) + (size_t)n * sizeof(int32_t)) return false;
+    trace.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        int32_t v;
+        memcpy(&v, &payload[1 + sizeof(n) + i * sizeof(v)], sizeof(v));
+        trace[i] = v;
+    }
+    return true;
+}
+
+// 填写 Unix 域套接字地址；路径过长时返回 false
+inline bool unixAddress(const string& path, sockaddr_un& addr) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
@@ -0,0 +1,198 @@
+﻿// 常驻分析服务：启动时载入若干文法并构造好分析表，之后通过 Unix 域套接字接受分析请求
+//
+// 编译：g++ -O2 -std=c++17 -pthread parse_server.cpp -o parse_server
+// 用法：parse_server [--socket 路径] [--max-connections N] 名字=文法文件[:ll|:lr] ...
+//
+// 文法文件采用仓库的文法格式（不含待分析的输入串），默认用 LR1Parser，后缀 :ll 时用 LL1Parser。
+// 协议见 parse_protocol.h。每个连接由一个线程处理，各线程只读共享的分析表与分词器，
+// 请求之间不再有进程启动、读文法与建表的开销。示例客户端见 parse_client.cpp。
+// 同时服务的连接至多 N 个（默认 16），达到上限时暂停 accept，新连接留在监听队列中等待；
+// 每个连接的帧缓冲区至多 kMaxFrame，内存因此有界。描述符或内存暂时耗尽时 accept 记录错误后退避重试，不退出。
+// 仅支持 POSIX 系统。
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "ll1_parser.h"
+#include "lr1_parser.h"
+#include "parse_protocol.h"
+#include "tokenizer.h"
+using namespace std;
+
+// 一个已载入的文法；载入后只读
+struct ServedGrammar {
+    unique_ptr<LL1Parser> ll;
+    unique_ptr<LR1Parser> lr;
+    Tokenizer lexer;
+
+    bool parse(const string& input, vector<int>& trace) const {
+        vector<int> tokens = lexer.tokenize(input);
+        return ll ? ll->recognize(tokens, &trace) : lr->recognize(tokens, &trace);
+    }
+};
+
+static map<string, unique_ptr<ServedGrammar>> grammars;
+
+// 载入 "名字=文法文件[:ll|:lr]"
+static bool loadServedGrammar(const string& spec) {
+    size_t eq = spec.find('=');
+    if (eq == string::npos || eq == 0 || eq > 255) {
+        cerr << "Bad grammar spec " << spec << " (expected NAME=FILE[:ll|:lr])" << endl;
+        return false;
+    }
+    string name = spec.substr(0, eq), path = spec.substr(eq + 1);
+    bool useLL = false;
+    if (path.size() > 3 && (path.compare(path.size() - 3, 3, ":ll") == 0 || path.compare(path.size() - 3, 3, ":lr") == 0)) {
+        useLL = path[path.size() - 1] == 'l';
+        path.resize(path.size() - 3);
+    }
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open grammar file " << path << endl;
+        return false;
+    }
+    auto g = unique_ptr<ServedGrammar>(new ServedGrammar());
+    if (useLL) {
+        g->ll.reset(new LL1Parser());
+        g->ll->loadGrammar(in, cerr);
+        g->ll->buildTables();
+        g->lexer.build(g->ll->grammar());
+    }
+    else {
+        g->lr.reset(new LR1Parser());
+        g->lr->loadGrammar(in, cerr);
+        g->lr->buildTables();
+        g->lexer.build(g->lr->grammar());
+    }
+    cerr << "Loaded " << name << " (" << (useLL ? "ll1" : "lr1") << ") from " << path << endl;
+    grammars[name] = move(g);
+    return true;
+}
+
+// 正在服务的连接数，由 main 限制在 --max-connections 以内
+static mutex connMtx;
+static condition_variable connCv;
+static unsigned activeConnections = 0;
+
+static void releaseConnection() {
+    {
+        lock_guard<mutex> lock(connMtx);
+        --activeConnections;
+    }
+    connCv.notify_one();
+}
+
+// accept 的错误是否只是暂时的（描述符、缓冲区或内存不足等），稍后重试即可；
+// 其余错误说明监听套接字本身不可用
+static bool transientAcceptError(int err) {
+    return err != EBADF && err != EINVAL && err != ENOTSOCK && err != EOPNOTSUPP && err != EFAULT;
+}
+
+static void serveClient(int fd) {
+    const size_t kKeepBuffer = 1 << 20; // 超过此大小的帧缓冲区用完即释放，空闲连接不占大块内存
+    string payload, name, input;
+    vector<int> trace;
+    while (readFrame(fd, payload)) {
+        uint8_t status;
+        trace.clear();
+        if (!decodeRequest(payload, name, input)) {
+            status = kParseBadRequest;
+        }
+        else {
+            auto it = grammars.find(name);
+            if (it == grammars.end()) status = kParseUnknownGrammar;
+            else status = it->second->parse(input, trace) ? kParseAccept : kParseReject;
+        }
+        if (!writeFrame(fd, encodeResponse(status, trace))) break;
+        if (payload.capacity() > kKeepBuffer) string().swap(payload);
+        if (input.capacity() > kKeepBuffer) string().swap(input);
+    }
+    close(fd);
+    releaseConnection();
+}
+
+int main(int argc, char** argv) {
+    string socketPath = "/tmp/parse_server.sock";
+    unsigned maxConnections = 16;
+    vector<string> specs;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--socket") && i + 1 < argc) socketPath = argv[++i];
+        else if (!strcmp(argv[i], "--max-connections") && i + 1 < argc) maxConnections = (unsigned)atoi(argv[++i]);
+        else specs.push_back(argv[i]);
+    }
+    if (specs.empty() || maxConnections == 0) {
+        cerr << "Usage: parse_server [--socket PATH] [--max-connections N] NAME=GRAMMAR[:ll|:lr] ..." << endl;
+        return 2;
+    }
+    for (auto& s : specs) {
+        if (!loadServedGrammar(s)) return 2;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    sockaddr_un addr;
+    if (!unixAddress(socketPath, addr)) {
+        cerr << "Socket path too long: " << socketPath << endl;
+        return 2;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(socketPath.c_str()); // 上次运行留下的套接字文件
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 128) != 0) {
+        perror("bind");
+        return 1;
+    }
+    cerr << "Listening on " << socketPath << endl;
+
+    int backoffMs = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(connMtx);
+            connCv.wait(lock, [&] { return activeConnections < maxConnections; });
+        }
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            int err = errno;
+            if (err == EINTR || err == ECONNABORTED) continue;
+            if (!transientAcceptError(err)) {
+                perror("accept");
+                break;
+            }
+            // 连续失败时退避时间加倍，至多 1 秒
+            backoffMs = backoffMs == 0 ? 10 : min(backoffMs * 2, 1000);
+            cerr << "accept: " << strerror(err) << ", retrying in " << backoffMs << " ms" << endl;
+            this_thread::sleep_for(chrono::milliseconds(backoffMs));
+            continue;
+        }
+        backoffMs = 0;
+        {
+            lock_guard<mutex> lock(connMtx);
+            ++activeConnections;
+        }
+        try {
+            thread(serveClient, fd).detach();
+        }
+        catch (const system_error& e) {
+            cerr << "Cannot start a thread for the connection: " << e.what() << endl;
+            close(fd);
+            releaseConnection();
+        }
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+    return 1;
+}
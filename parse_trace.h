@@ -0,0 +1,85 @@
+﻿// 分析过程输出的详细程度与增量渲染
+//
+// 环境变量 PARSER_TRACE 选择输出级别（main 没有命令行参数）：
+//   none         只输出接受或失败
+//   productions  每次预测输出一行所用的产生式
+//   full         （默认）每步输出栈、剩余输入与动作
+// full 级别下设置 PARSER_TRACE_WINDOW=N 时，栈只显示栈顶的 N 个符号、输入只显示其后的 N 个记号，
+// 每步输出长度有界，整个分析的时间与输出对输入长度是线性的。
+// SymbolStrip 维护“符号名加空格”拼接成的文本及每个符号的结束位置，压栈、弹栈只改动末尾，
+// 不必每步重新拼接整个栈或整个剩余输入。
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+enum TraceLevel { kTraceNone, kTraceProductions, kTraceFull };
+
+inline TraceLevel traceLevel() {
+    const char* v = getenv("PARSER_TRACE");
+    if (v == nullptr || *v == 0) return kTraceFull;
+    if (strcmp(v, "none") == 0) return kTraceNone;
+    if (strcmp(v, "productions") == 0) return kTraceProductions;
+    return kTraceFull;
+}
+
+// full 级别的窗口大小，0 表示不截断
+inline size_t traceWindow() {
+    const char* v = getenv("PARSER_TRACE_WINDOW");
+    return v == nullptr ? 0 : strtoull(v, nullptr, 10);
+}
+
+class SymbolStrip {
+public:
+    void clear() {
+        text.clear();
+        ends.clear();
+    }
+
+    void push(const string& name) {
+        text += name;
+        text += ' ';
+        ends.push_back(text.size());
+    }
+
+    void pop() {
+        ends.pop_back();
+        text.resize(ends.empty() ? 0 : ends.back());
+    }
+
+    size_t size() const { return ends.size(); }
+
+    // 第 i 个符号在 text 中的起点
+    size_t begin(size_t i) const { return i == 0 ? 0 : ends[i - 1]; }
+
+    // 输出符号 [from, to) 的文本，左对齐补足到 width 列；
+    // window 非 0 且超出时，ellipsisFront 为真只保留末尾 window 个符号，否则只保留开头 window 个
+    void write(ostream& out, size_t from, size_t to, size_t window, bool ellipsisFront, size_t width) const {
+        size_t n = 0;
+        bool cut = window != 0 && to - from > window;
+        if (cut && ellipsisFront) {
+            out.write("... ", 4);
+            n += 4;
+            from = to - window;
+        }
+        else if (cut) {
+            to = from + window;
+        }
+        size_t b = begin(from), e = to == 0 ? 0 : ends[to - 1];
+        out.write(text.data() + b, e - b);
+        n += e - b;
+        if (cut && !ellipsisFront) {
+            out.write("... ", 4);
+            n += 4;
+        }
+        for (; n < width; ++n) out.put(' ');
+    }
+
+private:
+    string text;
+    vector<size_t> ends;
+};
@@ -0,0 +1,128 @@
+﻿// 具体语法树（LL1Parser::recognize 在预测与匹配时构造）
+//
+// 所有结点存放在一个连续数组中，按分配顺序编号，根为 0 号。预测 X -> Y1 … Yk 时
+// 一次分配 k 个相邻的子结点，父结点只记录子结点区间，不另存指针或子结点表；
+// 结点共 24 字节，整棵树随 clear() 一次释放（保留容量，下次分析直接复用）。
+// 子结点的编号总是大于父结点，所以逆序扫描一遍即可自底向上汇总记号区间，
+// 遍历与输出也都用显式栈，百万级结点的深链（如循环符号展开）不会耗尽调用栈。
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "grammar.h"
+using namespace std;
+
+struct ParseNode {
+    int32_t symbol;
+    int32_t production;     // 所用产生式的下标，终结符为 -1
+    uint32_t firstChild;    // 子结点为 [firstChild, firstChild + childCount)
+    uint32_t childCount;
+    uint32_t tokenBegin;    // 覆盖的输入记号 [tokenBegin, tokenEnd)
+    uint32_t tokenEnd;
+};
+
+class ParseTree {
+public:
+    void clear() { nodes.clear(); }
+    bool empty() const { return nodes.empty(); }
+    size_t size() const { return nodes.size(); }
+    size_t bytes() const { return nodes.capacity() * sizeof(ParseNode); }
+
+    const ParseNode& node(uint32_t i) const { return nodes[i]; }
+    const ParseNode* childrenBegin(uint32_t i) const { return nodes.data() + nodes[i].firstChild; }
+    const ParseNode* childrenEnd(uint32_t i) const { return childrenBegin(i) + nodes[i].childCount; }
+
+    // 以开始符号建立根结点
+    uint32_t start(int symbol) {
+        nodes.clear();
+        return alloc(symbol, 0);
+    }
+
+    // 结点 n 按产生式 p 展开，pos 为当前输入位置；返回第一个子结点的编号
+    uint32_t expand(uint32_t n, int p, const Grammar& G, uint32_t pos) {
+        uint32_t first = (uint32_t)nodes.size();
+        for (const int* s = G.rhsBegin(p); s != G.rhsEnd(p); ++s) alloc(*s, pos);
+        ParseNode& x = nodes[n];
+        x.production = p;
+        x.tokenBegin = x.tokenEnd = pos; // ε 产生式的结点是 pos 处的空区间
+        x.firstChild = first;
+        x.childCount = (uint32_t)G.rhsLength(p);
+        return first;
+    }
+
+    // 终结符结点 n 与第 pos 个输入记号匹配
+    void match(uint32_t n, uint32_t pos) {
+        nodes[n].tokenBegin = pos;
+        nodes[n].tokenEnd = pos + 1;
+    }
+
+    // 分析结束后自底向上汇总非终结符的记号区间（ε 结点为空区间）
+    void finish() {
+        for (size_t i = nodes.size(); i-- > 0; ) {
+            ParseNode& x = nodes[i];
+            if (x.childCount > 0) {
+                x.tokenBegin = nodes[x.firstChild].tokenBegin;
+                x.tokenEnd = nodes[x.firstChild + x.childCount - 1].tokenEnd;
+            }
+        }
+    }
+
+    // 缩进形式输出，每个结点一行：符号名与记号区间。循环符号 L -> α L 展开出的 L 链
+    // 不再逐层缩进，而是与上一层的子结点并列，输出长度与结点数成正比
+    void write(ostream& out, const Grammar& G) const {
+        if (nodes.empty()) return;
+        vector<pair<uint32_t, uint32_t>> stack(1, make_pair(0u, 0u)); // (结点, 深度)
+        vector<uint32_t> chain;
+        string buf;
+        char num[16];
+        while (!stack.empty()) {
+            uint32_t n = stack.back().first, depth = stack.back().second;
+            stack.pop_back();
+            const ParseNode& x = nodes[n];
+            buf.append(2 * (size_t)depth, ' ');
+            buf += G.names[x.symbol];
+            buf += " [";
+            buf.append(num, to_chars(num, num + sizeof(num), x.tokenBegin).ptr);
+            buf += ',';
+            buf.append(num, to_chars(num, num + sizeof(num), x.tokenEnd).ptr);
+            buf += ")\n";
+            if (buf.size() >= (1 << 16)) {
+                out.write(buf.data(), buf.size());
+                buf.clear();
+            }
+            pushChildren(stack, chain, G, n, depth + 1);
+        }
+        out.write(buf.data(), buf.size());
+    }
+
+private:
+    vector<ParseNode> nodes;
+
+    uint32_t alloc(int symbol, uint32_t pos) {
+        nodes.push_back(ParseNode{ symbol, -1, 0, 0, pos, pos });
+        return (uint32_t)nodes.size() - 1;
+    }
+
+    // 子结点逆序入栈；最后一个子结点是同一循环符号时沿链展开它的子结点而不是它本身
+    void pushChildren(vector<pair<uint32_t, uint32_t>>& stack, vector<uint32_t>& chain,
+        const Grammar& G, uint32_t n, uint32_t depth) const {
+        chain.clear();
+        chain.push_back(n);
+        while (true) {
+            const ParseNode& x = nodes[chain.back()];
+            if (!G.isLoop(x.symbol) || x.childCount == 0) break;
+            uint32_t last = x.firstChild + x.childCount - 1;
+            if (nodes[last].symbol != x.symbol) break;
+            chain.push_back(last);
+        }
+        for (size_t k = chain.size(); k-- > 0; ) {
+            const ParseNode& x = nodes[chain[k]];
+            uint32_t end = x.firstChild + x.childCount - (k + 1 < chain.size() ? 1 : 0);
+            for (uint32_t c = end; c-- > x.firstChild; ) stack.emplace_back(c, depth);
+        }
+    }
+};
@@ -0,0 +1,148 @@
+﻿// 词法分析与语法分析的流水线
+//
+// 编译：g++ -O2 -std=c++17 -pthread pipeline.cpp -o pipeline
+// 用法：pipeline [--ll|--lr] [--map 映射文件] [--queue N] 文法文件 源文件
+//
+// 文法文件采用仓库的文法格式（不含待分析的输入串）。词法分析器（词法分析器源程序.cpp）在一个线程上
+// 扫描源文件，每个记号按 TokenMap 换成终结符编号后放入无锁环形队列；LL1Parser 或 LR1Parser
+// 在主线程上从队列逐个取记号分析，两边同时进行，不在内存中保存整个记号序列，也不经过文本输出。
+// 分析出错后词法线程不再入队，只送出结束标记。
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "ll1_parser.h"
+#include "lr1_parser.h"
+#include "spsc_queue.h"
+#include "token_map.h"
+#define LEXER_NO_MAIN
+#include "词法分析器源程序.cpp"
+using namespace std;
+
+// 队列中的记号：终结符编号、行号与截断后的词素（只用于报错）
+struct PipelineToken {
+    int terminal;
+    int line;
+    char text[24];
+};
+
+struct LexerSink {
+    const TokenMap* map;
+    SpscQueue<PipelineToken>* queue;
+    atomic<bool>* stop;
+    string lexeme; // 复用的缓冲区，避免每个记号分配一次
+};
+
+static void emitToken(void* ctx, int line, TokenType type, const char* value, int length) {
+    LexerSink* sink = (LexerSink*)ctx;
+    if (sink->stop->load(memory_order_relaxed)) return;
+    sink->lexeme.assign(value, (size_t)length);
+    PipelineToken tok;
+    tok.terminal = sink->map->map(type, sink->lexeme);
+    tok.line = line;
+    size_t n = min((size_t)length, sizeof(tok.text) - 1);
+    memcpy(tok.text, value, n);
+    tok.text[n] = 0;
+    sink->queue->push(tok);
+}
+
+template <typename Parser>
+static int runPipeline(Parser& parser, const string& grammarPath, const string& sourcePath,
+    const string& mapPath, size_t queueSize) {
+    ifstream grammarFile(grammarPath);
+    if (!grammarFile) {
+        cerr << "Cannot open grammar file " << grammarPath << endl;
+        return 2;
+    }
+    parser.loadGrammar(grammarFile, cerr);
+    parser.buildTables();
+    const Grammar& G = parser.grammar();
+
+    TokenMap map;
+    map.init(G, token_type_names, TOKEN_TYPE_COUNT);
+    if (!mapPath.empty()) {
+        ifstream mapFile(mapPath);
+        string err;
+        if (!mapFile) {
+            cerr << "Cannot open token map " << mapPath << endl;
+            return 2;
+        }
+        if (!map.load(mapFile, err)) {
+            cerr << mapPath << ": " << err << endl;
+            return 2;
+        }
+    }
+
+    FILE* source = fopen(sourcePath.c_str(), "r");
+    if (!source) {
+        cerr << "Cannot open source file " << sourcePath << endl;
+        return 2;
+    }
+
+    SpscQueue<PipelineToken> queue(queueSize);
+    atomic<bool> stop(false);
+    LexerSink sink{ &map, &queue, &stop, string() };
+    thread lexer([&]() {
+        LexerState state;
+        lexer_init(&state, source);
+        state.emit = emitToken;
+        state.emit_ctx = &sink;
+        lexer_run(&state);
+        PipelineToken end = { G.endMarker, state.line_number, "" };
+        queue.push(end);
+        free(state.lexeme);
+    });
+
+    PipelineToken last = { G.endMarker, 0, "" };
+    size_t count = 0;
+    bool accepted = parser.recognize([&]() {
+        last = queue.pop();
+        if (last.terminal != G.endMarker) ++count;
+        return last.terminal;
+    });
+    PipelineToken at = last;
+    stop.store(true, memory_order_relaxed);
+    while (last.terminal != G.endMarker) last = queue.pop(); // 取完剩余记号，让词法线程结束
+    lexer.join();
+    fclose(source);
+
+    if (accepted) {
+        cout << "accepted (" << count << " tokens)" << endl;
+        return 0;
+    }
+    if (at.terminal == G.endMarker) {
+        cout << "rejected at end of input (" << count << " tokens)" << endl;
+    }
+    else {
+        cout << "rejected at line " << at.line << " near '" << at.text << "' (token " << count << ")" << endl;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    bool lr = true;
+    string mapPath;
+    size_t queueSize = 4096;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--ll")) lr = false;
+        else if (!strcmp(argv[i], "--lr")) lr = true;
+        else if (!strcmp(argv[i], "--map") && i + 1 < argc) mapPath = argv[++i];
+        else if (!strcmp(argv[i], "--queue") && i + 1 < argc) queueSize = strtoull(argv[++i], nullptr, 10);
+        else files.push_back(argv[i]);
+    }
+    if (files.size() != 2) {
+        cerr << "Usage: pipeline [--ll|--lr] [--map FILE] [--queue N] GRAMMAR SOURCE" << endl;
+        return 2;
+    }
+    if (lr) {
+        LR1Parser parser;
+        return runPipeline(parser, files[0], files[1], mapPath, queueSize);
+    }
+    LL1Parser parser;
+    return runPipeline(parser, files[0], files[1], mapPath, queueSize);
+}
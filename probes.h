@@ -0,0 +1,34 @@
+﻿// 静态跟踪点（USDT）
+//
+// 有 <sys/sdt.h>（systemtap-sdt-dev）时，各探针编译成一条 nop 指令并在 ELF 的 .note.stapsdt 节中登记，
+// 未被跟踪时几乎没有开销；perf 或 bpftrace 可以直接挂到运行中的进程上，例如
+//   bpftrace -e 'usdt:./lr1:lr1:reduce { @[arg1] = count(); }' -p PID
+// 没有该头文件或定义了 PARSER_NO_USDT 时，探针只对参数求值后丢弃（不产生代码，也不会让仅供探针使用的变量报未使用）。
+// 提供者与探针（参数依次为）：
+//   lexer:token       行号, 记号种类, 词素, 词素长度
+//   lr1:state         状态编号, 项目数                （buildCanonicalCollection 新建状态）
+//   lr1:shift         状态, 终结符编号, 目标状态
+//   lr1:reduce        状态, 产生式编号
+//   lr1:accept        状态
+//   ll1:predict       非终结符编号, 终结符编号, 产生式编号
+//   ll1:match         终结符编号
+#pragma once
+
+#if !defined(PARSER_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PARSER_USDT 1
+#endif
+#endif
+
+#ifdef PARSER_USDT
+#define PARSER_PROBE1(provider, name, a) DTRACE_PROBE1(provider, name, a)
+#define PARSER_PROBE2(provider, name, a, b) DTRACE_PROBE2(provider, name, a, b)
+#define PARSER_PROBE3(provider, name, a, b, c) DTRACE_PROBE3(provider, name, a, b, c)
+#define PARSER_PROBE4(provider, name, a, b, c, d) DTRACE_PROBE4(provider, name, a, b, c, d)
+#else
+#define PARSER_PROBE1(provider, name, a) ((void)(a))
+#define PARSER_PROBE2(provider, name, a, b) ((void)(a), (void)(b))
+#define PARSER_PROBE3(provider, name, a, b, c) ((void)(a), (void)(b), (void)(c))
+#define PARSER_PROBE4(provider, name, a, b, c, d) ((void)(a), (void)(b), (void)(c), (void)(d))
+#endif
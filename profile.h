@@ -0,0 +1,169 @@
+﻿// 分阶段计时与内存统计（默认关闭）
+//
+// 设置环境变量 PARSER_PROFILE 后启用：值为 "-" 或 "1" 时报告写到标准错误，
+// 否则追加到该值指定的文件。每次运行输出一行 JSON，便于跨文法版本比较构造开销：
+//   {"engine":"lr1","grammar":"<规范化文法散列>",
+//    "phases":{"closure":{"calls":N,"ms":T},...},
+//    "stats":{"item_sets":N,"bytes_Action":B,...,"peak_rss_kb":K}}
+// 各阶段时间是包含关系（closure 的时间也计入 buildCanonicalCollection）。
+// 关闭时 ProfileScope 只有一次分支判断。
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+class Profiler {
+public:
+    Profiler() {
+        const char* v = getenv("PARSER_PROFILE");
+        if (v != nullptr && *v != 0) {
+            on = true;
+            target = v;
+        }
+    }
+
+    bool enabled() const { return on; }
+
+    // 记一次阶段调用；name 须为字符串字面量（按指针查找）
+    void add(const char* name, double seconds) {
+        for (auto& p : phases) {
+            if (p.name == name || strcmp(p.name, name) == 0) {
+                p.calls++;
+                p.seconds += seconds;
+                return;
+            }
+        }
+        phases.push_back(Phase{ name, 1, seconds });
+    }
+
+    // 记录一个统计量（覆盖同名的旧值）
+    void stat(const string& key, double value) {
+        for (auto& s : stats) {
+            if (s.first == key) {
+                s.second = value;
+                return;
+            }
+        }
+        stats.emplace_back(key, value);
+    }
+
+    // 输出报告，grammar 为规范化文法的散列
+    void report(const char* engine, uint64_t grammar) {
+        if (!on) return;
+        stat("peak_rss_kb", (double)peakRssKb());
+
+        ostringstream out;
+        char hash[17];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)grammar);
+        out << "{\"engine\":\"" << engine << "\",\"grammar\":\"" << hash << "\",\"phases\":{";
+        for (size_t i = 0; i < phases.size(); ++i) {
+            if (i) out << ",";
+            out << "\"" << phases[i].name << "\":{\"calls\":" << phases[i].calls
+                << ",\"ms\":" << number(phases[i].seconds * 1000) << "}";
+        }
+        out << "},\"stats\":{";
+        for (size_t i = 0; i < stats.size(); ++i) {
+            if (i) out << ",";
+            out << "\"" << stats[i].first << "\":" << number(stats[i].second);
+        }
+        out << "}}\n";
+
+        if (target == "-" || target == "1") {
+            cerr << out.str();
+        }
+        else {
+            ofstream f(target, ios::app);
+            if (f) f << out.str();
+            else cerr << "Cannot write profile to " << target << endl;
+        }
+    }
+
+    // 进程的峰值常驻内存（KB），不支持时为 0
+    static long peakRssKb() {
+#ifndef _WIN32
+        struct rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) == 0) return ru.ru_maxrss;
+#endif
+        return 0;
+    }
+
+private:
+    struct Phase {
+        const char* name;
+        long calls;
+        double seconds;
+    };
+    bool on = false;
+    string target;
+    vector<Phase> phases;
+    vector<pair<string, double>> stats;
+
+    static string number(double v) {
+        char buf[32];
+        if (v == (double)(long long)v) snprintf(buf, sizeof(buf), "%lld", (long long)v);
+        else snprintf(buf, sizeof(buf), "%.3f", v);
+        return buf;
+    }
+};
+
+inline Profiler& profiler() {
+    static Profiler p;
+    return p;
+}
+
+// 作用域计时：构造到析构之间的时间计入阶段 name
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(profiler().enabled() ? name : nullptr) {
+        if (this->name) start = chrono::steady_clock::now();
+    }
+    ~ProfileScope() {
+        if (name) profiler().add(name, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    chrono::steady_clock::time_point start;
+};
+
+// 内存估计：红黑树结点头部（颜色与三个指针）与堆分配的粒度
+const size_t kTreeNodeHeader = 32;
+inline size_t heapBlock(size_t n) { return (n + 15) / 16 * 16; }
+
+// 元素自身在堆上另外占用的字节数
+inline size_t heapExtra(int) { return 0; }
+inline size_t heapExtra(const string& s) { return s.capacity() > 15 ? heapBlock(s.capacity() + 1) : 0; }
+template <typename K, typename V>
+size_t heapExtra(const map<K, V>& m);
+
+template <typename T>
+size_t setBytes(const set<T>& s) {
+    return s.size() * heapBlock(kTreeNodeHeader + sizeof(T));
+}
+
+template <typename K, typename V>
+size_t mapBytes(const map<K, V>& m) {
+    size_t b = 0;
+    for (auto& e : m) b += heapBlock(kTreeNodeHeader + sizeof(e)) + heapExtra(e.second);
+    return b;
+}
+
+template <typename K, typename V>
+size_t heapExtra(const map<K, V>& m) { return mapBytes(m); }
@@ -0,0 +1,119 @@
+﻿// 生成的递归下降分析程序与表驱动 LL1Parser 的对比测试
+//
+// 编译（先用 rdgen 为同一文法生成 rd_generated.h）：
+//   ./rdgen --family tower --size 8 > rd_generated.h
+//   g++ -O2 -std=c++17 rd_bench.cpp -o rd_bench
+// 用法：rd_bench (文法文件 | --family tower|wide|list|c [--size N]) [--tokens T] [--length L] [--seed S]
+// 文法须与生成 rd_generated.h 时相同（按规范化文法的散列检查）。
+//
+// 用同一种子生成合法句子与各改动一个记号的近似合法句子（同 bench.cpp），
+// 分别由 LL1Parser::recognize 与生成的 rd::parse 分析，输出吞吐量（记号/秒）与接受数，
+// 并核对两者对每个句子的结论一致。
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_gen.h"
+#include "ll1_parser.h"
+#include "table_cache.h"
+#include "rd_generated.h"
+using namespace std;
+
+static double secondsSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+// 分析全部句子，返回 (秒, 接受数)，结论写入 verdicts
+template <typename F>
+static pair<double, size_t> timeAll(const vector<vector<int>>& sentences, vector<char>& verdicts, F parse) {
+    verdicts.assign(sentences.size(), 0);
+    size_t accepted = 0;
+    auto t = chrono::steady_clock::now();
+    for (size_t i = 0; i < sentences.size(); ++i) {
+        verdicts[i] = parse(sentences[i]);
+        accepted += verdicts[i];
+    }
+    return make_pair(secondsSince(t), accepted);
+}
+
+int main(int argc, char** argv) {
+    string path, family;
+    int size = 0;
+    size_t tokens = 200000, length = 1000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                cerr << "Missing value for " << argv[i] << endl;
+                exit(1);
+            }
+            return argv[++i];
+        };
+        if (!strcmp(argv[i], "--family")) family = value();
+        else if (!strcmp(argv[i], "--size")) size = atoi(value());
+        else if (!strcmp(argv[i], "--tokens")) tokens = strtoull(value(), nullptr, 10);
+        else if (!strcmp(argv[i], "--length")) length = strtoull(value(), nullptr, 10);
+        else if (!strcmp(argv[i], "--seed")) seed = strtoull(value(), nullptr, 10);
+        else path = argv[i];
+    }
+    string text;
+    if (!family.empty()) {
+        text = familyGrammar(family, size > 0 ? size : 8);
+    }
+    else if (!path.empty()) {
+        ifstream in(path);
+        text.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    if (text.empty()) {
+        cerr << "Usage: rd_bench (GRAMMAR | --family F [--size N]) [--tokens T] [--length L] [--seed S]" << endl;
+        return 2;
+    }
+
+    LL1Parser ll;
+    ostringstream log;
+    istringstream in(text);
+    ll.loadGrammar(in, log);
+    ll.buildTables();
+    vector<int32_t> key = grammarKey(ll.grammar());
+    if (fnv1a(key.data(), key.size() * sizeof(int32_t)) != rd::kGrammarHash) {
+        cerr << "rd_generated.h was generated from a different grammar; rerun rdgen" << endl;
+        return 1;
+    }
+
+    // 语料
+    SentenceGenerator gen(ll.grammar(), seed);
+    vector<vector<int>> valid, nearValid;
+    size_t validTokens = 0, nearTokens = 0;
+    while (validTokens < tokens) {
+        vector<int> s = gen.sentence(length);
+        validTokens += s.size() + 1;
+        nearValid.push_back(gen.mutate(s));
+        nearTokens += nearValid.back().size() + 1;
+        valid.push_back(move(s));
+    }
+
+    cout << "engine\tvalid_tok_s\tvalid_accepted\tnear_tok_s\tnear_accepted\n";
+    vector<char> tableValid, tableNear, rdValid, rdNear;
+    auto table = [&](const vector<int>& s) { return ll.recognize(s); };
+    auto generated = [&](const vector<int>& s) { return rd::parse(s.data(), s.size()); };
+    auto tv = timeAll(valid, tableValid, table), tn = timeAll(nearValid, tableNear, table);
+    auto rv = timeAll(valid, rdValid, generated), rn = timeAll(nearValid, rdNear, generated);
+    auto row = [&](const char* engine, pair<double, size_t> v, pair<double, size_t> n) {
+        cout << engine << "\t" << fixed << setprecision(0) << validTokens / max(v.first, 1e-9) << "\t"
+            << v.second << "/" << valid.size() << "\t" << nearTokens / max(n.first, 1e-9) << "\t"
+            << n.second << "/" << nearValid.size() << "\n";
+    };
+    row("table", tv, tn);
+    row("generated", rv, rn);
+
+    if (tableValid != rdValid || tableNear != rdNear) {
+        cerr << "Generated parser disagrees with the table-driven parser" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+﻿// 由 LL(1) 分析表生成递归下降分析程序（C++ 源码）
+//
+// 每个非终结符生成一个函数，按向前看终结符编号 switch，分支由分析表导出：
+// M[X,a] = p 的终结符 a 都成为产生式 p 分支的 case 标号；分支内依次匹配终结符或调用非终结符的函数。
+// 循环符号 L -> α L | … 生成为函数内的 while 循环（α 之后 continue），长列表不会加深递归。
+// 终结符编号与 LL1Parser 化简、编号后的文法一致，kGrammarHash 为规范化文法的散列，
+// 使用方可以据此确认生成代码与当前文法对应。
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "ll1_parser.h"
+#include "table_cache.h"
+using namespace std;
+
+// 注释中的符号名：反斜杠放在行尾会把下一行并入注释，改写掉
+inline string rdComment(const string& s) {
+    string r;
+    for (char c : s) {
+        if (c == '\\') r += "<backslash>";
+        else r += c;
+    }
+    return r;
+}
+
+inline void rdProductionComment(ostream& out, const Grammar& G, int p, const char* indent) {
+    out << indent << "// " << G.prodNumber[p] << ": " << rdComment(G.names[G.prodLhs[p]]) << " ->";
+    if (G.rhsLength(p) == 0) out << " " << rdComment(G.names[G.epsilon]);
+    for (const int* s = G.rhsBegin(p); s != G.rhsEnd(p); ++s) out << " " << rdComment(G.names[*s]);
+    out << "\n";
+}
+
+// 生成代码：命名空间 ns 中的 bool parse(const int* tokens, size_t n)
+inline void generateRecursiveDescent(const LL1Parser& parser, const string& ns, ostream& out) {
+    const Grammar& G = parser.grammar();
+    const auto& table = parser.table();
+    int T = G.numTerminals;
+    vector<int32_t> key = grammarKey(G);
+    char hash[32];
+    snprintf(hash, sizeof(hash), "0x%016llxull", (unsigned long long)fnv1a(key.data(), key.size() * sizeof(int32_t)));
+
+    out << "// 由 rdgen 根据 LL(1) 分析表生成，请勿手工修改\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n\n"
+        << "namespace " << ns << " {\n\n"
+        << "const uint64_t kGrammarHash = " << hash << ";\n"
+        << "const int kEnd = " << G.endMarker << ";\n\n"
+        << "struct Cursor {\n"
+        << "    const int* next;\n"
+        << "    const int* end;\n"
+        << "    int la;\n"
+        << "    void advance() { la = next != end ? *next++ : kEnd; }\n"
+        << "};\n\n";
+    for (int X = T; X < G.numSymbols(); ++X) {
+        out << "inline bool parse_" << X << "(Cursor& c); // " << rdComment(G.names[X]) << "\n";
+    }
+    out << "\n";
+
+    for (int X = T; X < G.numSymbols(); ++X) {
+        bool loop = G.isLoop(X);
+        const char* ind = loop ? "        " : "    ";
+        out << "inline bool parse_" << X << "(Cursor& c) {\n";
+        if (loop) out << "    while (true) {\n";
+        out << ind << "switch (c.la) {\n";
+
+        // 产生式 -> 选择它的终结符
+        map<int, vector<int>> cases;
+        auto row = table.find(X);
+        if (row != table.end()) {
+            for (auto& e : row->second) cases[G.productionIndex(e.second)].push_back(e.first);
+        }
+        for (auto& c : cases) {
+            int p = c.first;
+            for (int a : c.second) out << ind << "case " << a << ": // " << rdComment(G.names[a]) << "\n";
+            rdProductionComment(out, G, p, (string(ind) + "    ").c_str());
+            const int* end = G.rhsEnd(p);
+            bool again = loop && G.rhsLength(p) > 0; // L -> α L：α 之后回到循环开头
+            if (again) --end;
+            for (const int* s = G.rhsBegin(p); s != end; ++s) {
+                if (G.isTerminal(*s)) {
+                    out << ind << "    if (c.la != " << *s << ") return false;\n"
+                        << ind << "    c.advance();\n";
+                }
+                else {
+                    out << ind << "    if (!parse_" << *s << "(c)) return false;\n";
+                }
+            }
+            out << ind << (again ? "    continue;\n" : "    return true;\n");
+        }
+        out << ind << "default:\n"
+            << ind << "    return false;\n"
+            << ind << "}\n";
+        if (loop) out << "    }\n";
+        out << "}\n\n";
+    }
+
+    out << "// tokens 为终结符编号序列（不含末尾的 $）\n"
+        << "inline bool parse(const int* tokens, size_t n) {\n"
+        << "    Cursor c{ tokens, tokens + n, kEnd };\n"
+        << "    c.advance();\n"
+        << "    return parse_" << G.startSymbol << "(c) && c.la == kEnd;\n"
+        << "}\n\n"
+        << "} // namespace " << ns << "\n";
+}
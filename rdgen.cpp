@@ -0,0 +1,59 @@
+﻿// 递归下降分析程序生成器
+//
+// 编译：g++ -O2 -std=c++17 rdgen.cpp -o rdgen
+// 用法：rdgen [--namespace NS] (文法文件 | --family tower|wide|list|c [--size N]) > 输出.h
+//
+// 文法文件采用仓库的文法格式（不含待分析的输入串），也可以用 --family 取基准测试的文法族（见 bench_gen.h）。
+// 读入文法、化简并构造 LL(1) 分析表后，输出一个只依赖标准头文件的 C++ 头文件（见 rd_codegen.h），
+// 其中 NS::parse(tokens, n) 判断终结符编号序列能否被接受。生成的分析程序与表驱动分析程序的比较见 rd_bench.cpp。
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "bench_gen.h"
+#include "ll1_parser.h"
+#include "rd_codegen.h"
+using namespace std;
+
+int main(int argc, char** argv) {
+    string ns = "rd", path, family;
+    int size = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--namespace") && i + 1 < argc) ns = argv[++i];
+        else if (!strcmp(argv[i], "--family") && i + 1 < argc) family = argv[++i];
+        else if (!strcmp(argv[i], "--size") && i + 1 < argc) size = atoi(argv[++i]);
+        else path = argv[i];
+    }
+    string text;
+    if (!family.empty()) {
+        text = familyGrammar(family, size > 0 ? size : 8);
+        if (text.empty()) {
+            cerr << "Unknown grammar family: " << family << endl;
+            return 2;
+        }
+    }
+    else if (!path.empty()) {
+        ifstream in(path);
+        if (!in) {
+            cerr << "Cannot open grammar file " << path << endl;
+            return 2;
+        }
+        text.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    else {
+        cerr << "Usage: rdgen [--namespace NS] (GRAMMAR | --family F [--size N]) > parser.h" << endl;
+        return 2;
+    }
+    istringstream in(text);
+    LL1Parser parser;
+    parser.loadGrammar(in, cerr);
+    parser.buildTables();
+    if (parser.conflictCount() > 0) {
+        cerr << "Grammar is not LL(1); the generated parser cannot resolve conflicting table entries" << endl;
+        return 1;
+    }
+    generateRecursiveDescent(parser, ns, cout);
+    return 0;
+}
@@ -0,0 +1,225 @@
+﻿// 文法化简：在建表之前去掉无用的产生式与符号
+//
+//   1. 去掉推不出终结符串的非终结符（非生成符号）及含有它们的产生式
+//   2. 去掉从开始符号不可达的非终结符及其产生式
+//   3. 合并候选式完全相同的非终结符，并去掉同一左部下重复的候选式
+//   4. 去掉不再被任何产生式使用的终结符（e 与 $ 除外）
+// 保留下来的产生式保持原来的输入序号（Grammar::prodNumber）。
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "grammar.h"
+using namespace std;
+
+// 化简文法 G，被去掉的内容写到 log；没有可化简的内容时不输出
+inline void reduceGrammar(Grammar& G, ostream& log) {
+    int T = G.numTerminals, N = G.numNonTerminals(), P = G.numProductions();
+    vector<char> keepProd(P, 1);
+    vector<string> report;
+
+    auto prodText = [&](int p) {
+        string s = to_string(G.prodNumber[p]) + ": " + G.names[G.prodLhs[p]] + " ->";
+        if (G.rhsLength(p) == 0) s += " " + G.names[G.epsilon];
+        for (const int* x = G.rhsBegin(p); x != G.rhsEnd(p); ++x) s += " " + G.names[*x];
+        return s;
+    };
+
+    // 1. 生成符号：右部中尚未确定为生成符号的非终结符个数降为 0 时，左部是生成符号
+    vector<char> productive(N, 0);
+    {
+        vector<int> unknown(P, 0), occOffset(N + 1, 0), occ;
+        for (int p = 0; p < P; ++p) {
+            for (const int* x = G.rhsBegin(p); x != G.rhsEnd(p); ++x) {
+                if (G.isNonTerminal(*x)) {
+                    unknown[p]++;
+                    occOffset[*x - T + 1]++;
+                }
+            }
+        }
+        for (int B = 0; B < N; ++B) occOffset[B + 1] += occOffset[B];
+        occ.resize(occOffset[N]);
+        vector<int> fill(occOffset.begin(), occOffset.end() - 1);
+        for (int p = 0; p < P; ++p) {
+            for (const int* x = G.rhsBegin(p); x != G.rhsEnd(p); ++x) {
+                if (G.isNonTerminal(*x)) occ[fill[*x - T]++] = p;
+            }
+        }
+        vector<int> work;
+        for (int p = 0; p < P; ++p) {
+            int A = G.prodLhs[p] - T;
+            if (unknown[p] == 0 && !productive[A]) {
+                productive[A] = 1;
+                work.push_back(A);
+            }
+        }
+        while (!work.empty()) {
+            int B = work.back();
+            work.pop_back();
+            for (int k = occOffset[B]; k < occOffset[B + 1]; ++k) {
+                int p = occ[k];
+                int A = G.prodLhs[p] - T;
+                if (--unknown[p] == 0 && !productive[A]) {
+                    productive[A] = 1;
+                    work.push_back(A);
+                }
+            }
+        }
+    }
+    if (!productive[G.startSymbol - T]) {
+        // 语言为空，化简会删掉全部产生式，保持原文法不变
+        log << "Grammar reduction: start symbol " << G.names[G.startSymbol] << " derives no terminal string, grammar left unchanged\n";
+        return;
+    }
+    for (int A = 0; A < N; ++A) {
+        if (!productive[A]) report.push_back("removed nonterminal " + G.names[A + T] + " (derives no terminal string)");
+    }
+    for (int p = 0; p < P; ++p) {
+        bool ok = productive[G.prodLhs[p] - T];
+        for (const int* x = G.rhsBegin(p); ok && x != G.rhsEnd(p); ++x) {
+            if (G.isNonTerminal(*x) && !productive[*x - T]) ok = false;
+        }
+        if (!ok) {
+            keepProd[p] = 0;
+            report.push_back("removed production " + prodText(p));
+        }
+    }
+
+    // 2. 从开始符号出发的可达非终结符
+    vector<char> reachable(N, 0);
+    {
+        vector<int> work(1, G.startSymbol - T);
+        reachable[G.startSymbol - T] = 1;
+        while (!work.empty()) {
+            int A = work.back();
+            work.pop_back();
+            for (const int* q = G.altsBegin(A + T); q != G.altsEnd(A + T); ++q) {
+                if (!keepProd[*q]) continue;
+                for (const int* x = G.rhsBegin(*q); x != G.rhsEnd(*q); ++x) {
+                    if (G.isNonTerminal(*x) && !reachable[*x - T]) {
+                        reachable[*x - T] = 1;
+                        work.push_back(*x - T);
+                    }
+                }
+            }
+        }
+    }
+    for (int A = 0; A < N; ++A) {
+        if (productive[A] && !reachable[A]) report.push_back("removed nonterminal " + G.names[A + T] + " (unreachable from " + G.names[G.startSymbol] + ")");
+    }
+    for (int p = 0; p < P; ++p) {
+        if (keepProd[p] && !reachable[G.prodLhs[p] - T]) {
+            keepProd[p] = 0;
+            report.push_back("removed production " + prodText(p));
+        }
+    }
+
+    // 3. 合并候选式完全相同的非终结符，直到不再变化（合并后可能产生新的相同者）。
+    //    repr[A] 为 A 合并到的非终结符；开始符号总是作为代表
+    vector<int> repr(N);
+    for (int A = 0; A < N; ++A) repr[A] = A;
+    auto mapSym = [&](int x) { return G.isNonTerminal(x) ? repr[x - T] + T : x; };
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        map<vector<vector<int>>, int> byAlternatives;
+        for (int A = 0; A < N; ++A) {
+            if (repr[A] != A || !reachable[A] || !productive[A]) continue;
+            vector<vector<int>> key;
+            for (const int* q = G.altsBegin(A + T); q != G.altsEnd(A + T); ++q) {
+                if (!keepProd[*q]) continue;
+                vector<int> alt;
+                for (const int* x = G.rhsBegin(*q); x != G.rhsEnd(*q); ++x) alt.push_back(mapSym(*x));
+                key.push_back(alt);
+            }
+            sort(key.begin(), key.end());
+            key.erase(unique(key.begin(), key.end()), key.end());
+            auto ins = byAlternatives.emplace(key, A);
+            if (ins.second) continue;
+            int keep = ins.first->second, drop = A;
+            if (drop == G.startSymbol - T) {
+                swap(keep, drop);
+                ins.first->second = keep;
+            }
+            report.push_back("merged nonterminal " + G.names[drop + T] + " into " + G.names[keep + T] + " (identical alternatives)");
+            for (int B = 0; B < N; ++B) {
+                if (repr[B] == drop) repr[B] = keep;
+            }
+            merged = true;
+        }
+    }
+
+    // 改写右部中被合并的符号，去掉被合并者的产生式以及同一左部下重复的候选式
+    for (int& x : G.rhs) x = mapSym(x);
+    {
+        map<pair<int, vector<int>>, int> seen;
+        for (int p = 0; p < P; ++p) {
+            if (!keepProd[p]) continue;
+            int A = G.prodLhs[p] - T;
+            if (repr[A] != A) {
+                keepProd[p] = 0;
+                continue;
+            }
+            vector<int> alt(G.rhsBegin(p), G.rhsEnd(p));
+            if (!seen.emplace(make_pair(A, alt), p).second) {
+                keepProd[p] = 0;
+                report.push_back("removed production " + prodText(p) + " (duplicate alternative)");
+            }
+        }
+    }
+
+    // 4. 重新编号：保留被使用的终结符（以及 e、$）和留下的非终结符，各区间内仍按名字排序
+    vector<char> keepSym(G.numSymbols(), 0);
+    keepSym[G.epsilon] = keepSym[G.endMarker] = 1;
+    for (int p = 0; p < P; ++p) {
+        if (!keepProd[p]) continue;
+        keepSym[G.prodLhs[p]] = 1;
+        for (const int* x = G.rhsBegin(p); x != G.rhsEnd(p); ++x) keepSym[*x] = 1;
+    }
+    keepSym[G.startSymbol] = 1;
+    for (int t = 0; t < T; ++t) {
+        if (!keepSym[t]) report.push_back("removed terminal " + G.names[t] + " (unused)");
+    }
+
+    if (report.empty()) return;
+    log << "Grammar reduction:\n";
+    for (auto& line : report) log << "  " << line << "\n";
+
+    vector<int> remap(G.numSymbols(), -1);
+    vector<string> names;
+    vector<char> loop;
+    int numTerminals = 0;
+    for (int x = 0; x < G.numSymbols(); ++x) {
+        if (!keepSym[x]) continue;
+        remap[x] = (int)names.size();
+        names.push_back(G.names[x]);
+        loop.push_back(G.loop[x]);
+        if (x < T) numTerminals++;
+    }
+
+    vector<int> prodLhs, prodOffset(1, 0), rhs, prodNumber;
+    for (int p = 0; p < P; ++p) {
+        if (!keepProd[p]) continue;
+        prodLhs.push_back(remap[G.prodLhs[p]]);
+        for (const int* x = G.rhsBegin(p); x != G.rhsEnd(p); ++x) rhs.push_back(remap[*x]);
+        prodOffset.push_back((int)rhs.size());
+        prodNumber.push_back(G.prodNumber[p]);
+    }
+
+    G.names = names;
+    G.loop = loop;
+    G.ids.clear();
+    for (int x = 0; x < (int)names.size(); ++x) G.ids.emplace(names[x], x);
+    G.numTerminals = numTerminals;
+    G.epsilon = remap[G.epsilon];
+    G.endMarker = remap[G.endMarker];
+    G.startSymbol = remap[G.startSymbol];
+    G.prodLhs = prodLhs;
+    G.prodOffset = prodOffset;
+    G.rhs = rhs;
+    G.prodNumber = prodNumber;
+    G.buildAlternatives();
+}
@@ -0,0 +1,64 @@
+﻿// 单生产者单消费者的无锁环形队列（词法分析线程 -> 语法分析线程）
+//
+// 容量取 2 的幂，下标用单调递增的计数器，按位与取槽位。生产者只写 tail、消费者只写 head，
+// 各自用 release 发布、对方用 acquire 读取，不需要锁或 CAS。两个计数器分占不同的缓存行，
+// 并各自缓存对方计数器的最近一次读数，只有看起来满（空）时才重新读取，减少缓存行来回传递。
+// 队列满或空时先自旋若干次再让出处理器。
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+using namespace std;
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 4096) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    // 生产者：放入一个元素，队列满时等待
+    void push(const T& value) {
+        size_t t = tail.load(memory_order_relaxed);
+        for (int spins = 0; t - headCache > mask; ++spins) {
+            headCache = head.load(memory_order_acquire);
+            if (t - headCache > mask) backoff(spins);
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, memory_order_release);
+    }
+
+    // 消费者：取出一个元素，队列空时等待
+    T pop() {
+        size_t h = head.load(memory_order_relaxed);
+        for (int spins = 0; h == tailCache; ++spins) {
+            tailCache = tail.load(memory_order_acquire);
+            if (h == tailCache) backoff(spins);
+        }
+        T value = slots[h & mask];
+        head.store(h + 1, memory_order_release);
+        return value;
+    }
+
+private:
+    vector<T> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> head{ 0 };  // 消费者下一次读取的位置
+    size_t tailCache = 0;                  // 消费者看到的 tail
+    alignas(64) atomic<size_t> tail{ 0 };  // 生产者下一次写入的位置
+    size_t headCache = 0;                  // 生产者看到的 head
+    char pad[64 - sizeof(size_t)];
+
+    static void backoff(int spins) {
+        if (spins >= 64) this_thread::yield();
+    }
+};
@@ -0,0 +1,206 @@
+﻿// 分析表的磁盘缓存
+//
+// 文法没有变化时不必每次重新构造分析表：构造完成后把表写入缓存目录，
+// 下次启动时按规范化文法（化简、编号之后的 Grammar）找到缓存文件，mmap 后直接读出。
+// 缓存目录由环境变量 PARSE_TABLE_CACHE 指定，未设置时不读写缓存。
+//
+// 文件由若干节组成，全部是 32 位整数，mmap 后可以直接按数组访问：
+//   头部    magic, version, engine, sectionCount
+//   节表    每节的起始位置与长度（以 int32 计）
+//   第 0 节 规范化文法的序列化，读取时逐字比较，防止散列冲突
+//   其余节  由各分析程序自行约定
+// 文件名为 <engine>-<规范化文法的 64 位 FNV-1a 散列>.tbl；写入时先写临时文件再改名，
+// 临时文件名各不相同，多个进程（或同一进程的多个线程）共用缓存目录时不会互相覆盖或删除。
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "grammar.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+using namespace std;
+
+const int32_t kTableCacheMagic = 0x43425450;   // "PTBC"
+const int32_t kTableCacheVersion = 1;          // 格式变化时递增，旧文件自动失效
+
+enum TableCacheEngine : int32_t { kCacheLL1 = 1, kCacheLR1 = 2 };
+
+// 规范化文法的序列化：符号名、符号分类、开始符号与全部产生式
+inline vector<int32_t> grammarKey(const Grammar& G) {
+    vector<int32_t> key;
+    key.push_back(G.numSymbols());
+    key.push_back(G.numTerminals);
+    key.push_back(G.epsilon);
+    key.push_back(G.endMarker);
+    key.push_back(G.startSymbol);
+    for (int x = 0; x < G.numSymbols(); ++x) {
+        key.push_back((int32_t)G.names[x].size());
+        for (unsigned char c : G.names[x]) key.push_back(c);
+        key.push_back(G.loop[x]);
+    }
+    key.push_back(G.numProductions());
+    key.insert(key.end(), G.prodLhs.begin(), G.prodLhs.end());
+    key.insert(key.end(), G.prodOffset.begin(), G.prodOffset.end());
+    key.insert(key.end(), G.rhs.begin(), G.rhs.end());
+    key.insert(key.end(), G.prodNumber.begin(), G.prodNumber.end());
+    return key;
+}
+
+inline uint64_t fnv1a(const void* data, size_t n) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// 缓存文件路径；未启用缓存时返回空串
+inline string tableCachePath(int32_t engine, const vector<int32_t>& key) {
+    const char* dir = getenv("PARSE_TABLE_CACHE");
+    if (dir == nullptr || *dir == 0) return "";
+    char name[64];
+    snprintf(name, sizeof(name), "/%s-%016llx.tbl", engine == kCacheLL1 ? "ll1" : "lr1",
+        (unsigned long long)fnv1a(key.data(), key.size() * sizeof(int32_t)));
+    return string(dir) + name;
+}
+
+// 写缓存：sections[0] 须为 grammarKey
+inline bool writeTableCache(const string& path, int32_t engine, const vector<vector<int32_t>>& sections) {
+    vector<int32_t> head = { kTableCacheMagic, kTableCacheVersion, engine, (int32_t)sections.size() };
+    int64_t pos = (int64_t)head.size() + 2 * (int64_t)sections.size();
+    for (auto& s : sections) {
+        head.push_back((int32_t)pos);
+        head.push_back((int32_t)s.size());
+        pos += (int64_t)s.size();
+    }
+    if (pos > INT32_MAX) return false;
+
+#ifndef _WIN32
+    string tmp = path + ".XXXXXX";
+    int fd = mkstemp(&tmp[0]);
+    if (fd < 0) return false;
+    fchmod(fd, 0644); // mkstemp 建立的文件只有属主可读
+    FILE* f = fdopen(fd, "wb");
+    if (f == nullptr) {
+        ::close(fd);
+        remove(tmp.c_str());
+        return false;
+    }
+#else
+    static atomic<unsigned> seq(0);
+    string tmp = path + "." + to_string(_getpid()) + "." + to_string(seq++) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr) return false;
+#endif
+    bool ok = fwrite(head.data(), sizeof(int32_t), head.size(), f) == head.size();
+    for (auto& s : sections) {
+        ok = ok && fwrite(s.data(), sizeof(int32_t), s.size(), f) == s.size();
+    }
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok) remove(tmp.c_str());
+    return ok;
+}
+
+// 只读映射的缓存文件
+class TableCache {
+public:
+    TableCache() {}
+    ~TableCache() { close(); }
+    TableCache(const TableCache&) = delete;
+    TableCache& operator=(const TableCache&) = delete;
+
+    // 打开并校验缓存文件：格式、版本、分析程序种类与规范化文法都须一致
+    bool open(const string& path, int32_t engine, const vector<int32_t>& key) {
+        close();
+        if (path.empty() || !map(path)) return false;
+        if (size < 4 || data[0] != kTableCacheMagic || data[1] != kTableCacheVersion || data[2] != engine
+            || data[3] < 1 || size < 4 + 2 * (size_t)data[3]) {
+            close();
+            return false;
+        }
+        for (int k = 0; k < data[3]; ++k) {
+            int32_t b = data[4 + 2 * k], n = data[5 + 2 * k];
+            if (b < 0 || n < 0 || (size_t)b + (size_t)n > size) {
+                close();
+                return false;
+            }
+        }
+        if (sectionSize(0) != key.size() || memcmp(section(0), key.data(), key.size() * sizeof(int32_t)) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    int sections() const { return data ? data[3] : 0; }
+    const int32_t* section(int k) const { return data + data[4 + 2 * k]; }
+    size_t sectionSize(int k) const { return (size_t)data[5 + 2 * k]; }
+
+    void close() {
+        if (data == nullptr) return;
+#ifndef _WIN32
+        munmap((void*)data, size * sizeof(int32_t));
+#else
+        delete[] data;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+private:
+    const int32_t* data = nullptr;
+    size_t size = 0; // 以 int32 计
+
+    bool map(const string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)(4 * sizeof(int32_t)) || st.st_size % sizeof(int32_t) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (const int32_t*)p;
+        size = (size_t)st.st_size / sizeof(int32_t);
+        return true;
+#else
+        // 没有 mmap 时整个读入内存
+        FILE* f = fopen(path.c_str(), "rb");
+        if (f == nullptr) return false;
+        fseek(f, 0, SEEK_END);
+        long n = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (n < (long)(4 * sizeof(int32_t)) || n % sizeof(int32_t) != 0) {
+            fclose(f);
+            return false;
+        }
+        int32_t* buf = new int32_t[n / sizeof(int32_t)];
+        bool ok = fread(buf, 1, (size_t)n, f) == (size_t)n;
+        fclose(f);
+        if (!ok) {
+            delete[] buf;
+            return false;
+        }
+        data = buf;
+        size = (size_t)n / sizeof(int32_t);
+        return true;
+#endif
+    }
+};
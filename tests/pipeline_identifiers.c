@@ -0,0 +1 @@
+int main() { int num; num = 1; return num; }
@@ -0,0 +1,23 @@
+#!/bin/sh
+# pipeline 的回归测试：每个 *.c 源文件须在 LL 与 LR 两种模式下都被 C 子集文法接受
+#
+# 用法：tests/run_pipeline_tests.sh [pipeline 可执行文件]（默认在仓库根目录编译 pipeline.cpp）
+#   pipeline_identifiers.c  与终结符同名的标识符（num）须按种类映射为 id，而不是终结符 num
+cd "$(dirname "$0")" || exit 2
+bin="$1"
+if [ -z "$bin" ]; then
+    bin=./pipeline_test_bin
+    g++ -O2 -std=c++17 -pthread ../pipeline.cpp -o "$bin" || exit 2
+fi
+failed=0
+for src in *.c; do
+    for mode in --ll --lr; do
+        if ! out=$("$bin" $mode --map c_subset.map c_subset.grammar "$src"); then
+            echo "FAIL $src $mode: $out"
+            failed=1
+        fi
+    done
+done
+[ -z "$1" ] && rm -f "$bin"
+[ $failed -eq 0 ] && echo "all pipeline tests passed"
+exit $failed
@@ -0,0 +1,83 @@
+﻿// 简单的固定大小线程池
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class ThreadPool {
+public:
+    // n 为工作线程数，0 表示取硬件并发数
+    explicit ThreadPool(unsigned n = 0) {
+        if (n == 0) n = defaultThreads();
+        for (unsigned i = 0; i < n; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        taskCv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    static unsigned defaultThreads() {
+        unsigned n = thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // 提交任务；任务内部也可以继续提交
+    void submit(function<void()> task) {
+        {
+            lock_guard<mutex> lock(mtx);
+            tasks.push(move(task));
+            pending++;
+        }
+        taskCv.notify_one();
+    }
+
+    // 等待所有已提交的任务（包括执行期间新提交的）完成
+    void wait() {
+        unique_lock<mutex> lock(mtx);
+        doneCv.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex mtx;
+    condition_variable taskCv;
+    condition_variable doneCv;
+    size_t pending = 0; // 已提交但尚未完成的任务数
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(mtx);
+                taskCv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = move(tasks.front());
+                tasks.pop();
+            }
+            task();
+            {
+                lock_guard<mutex> lock(mtx);
+                if (--pending == 0) doneCv.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,95 @@
+﻿// 词法分析器记号到文法终结符的映射
+//
+// 词法分析器给出（种类, 词素），分析表只认终结符编号，两者按下面的顺序对应：
+//   1. 词素映射：只用于关键字、运算符与界符（KEYWORD、OPERATOR、DELIMITER）。词素与某个终结符同名时
+//      就是该终结符（if、+ 等），映射文件可以另外指定或覆盖（如把 "(" 映射到 lp）；
+//   2. 种类映射：按记号种类映射（默认 IDENTIFIER -> id、NUMBER -> num、
+//      STRING -> string、CHARCON -> charcon，文法中没有该终结符时不映射）。
+//      标识符、数与字符串常量总是按种类映射，名为 num 的标识符仍是 id；
+//   3. 都不匹配时为 -1，分析程序在该记号处报错。
+// 映射文件每行一条“左部 终结符”，左部是种类名时为种类映射，否则为词素映射；# 开头的行是注释。
+//   IDENTIFIER  id
+//   (           lp
+//   ==          eqeq
+#pragma once
+
+#include <istream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "grammar.h"
+using namespace std;
+
+class TokenMap {
+public:
+    // typeNames[k] 为第 k 种记号的名字（与词法分析器的种类编号一致）
+    void init(const Grammar& g, const char* const* typeNames, int typeCount) {
+        G = &g;
+        types.assign(typeNames, typeNames + typeCount);
+        byType.assign(typeCount, -1);
+        lexemeTypes.assign(typeCount, 0);
+        for (const char* name : { "KEYWORD", "OPERATOR", "DELIMITER" }) {
+            int k = typeIndex(name);
+            if (k >= 0) lexemeTypes[k] = 1;
+        }
+        byLexeme.clear();
+        for (int t = 0; t < G->numTerminals; ++t) {
+            if (t != G->epsilon && t != G->endMarker) byLexeme[G->names[t]] = t;
+        }
+        const char* defaults[][2] = {
+            { "IDENTIFIER", "id" }, { "NUMBER", "num" }, { "STRING", "string" }, { "CHARCON", "charcon" }
+        };
+        for (auto& d : defaults) {
+            int k = typeIndex(d[0]), t = G->lookup(d[1]);
+            if (k >= 0 && t >= 0 && G->isTerminal(t)) byType[k] = t;
+        }
+    }
+
+    // 读入映射文件；出错时返回 false 并在 err 中给出行号与原因
+    bool load(istream& in, string& err) {
+        string line;
+        for (int lineNo = 1; getline(in, line); ++lineNo) {
+            istringstream ss(line);
+            string left, right, extra;
+            if (!(ss >> left) || left[0] == '#') continue;
+            if (!(ss >> right) || (ss >> extra)) {
+                err = "line " + to_string(lineNo) + ": expected '<token type or lexeme> <terminal>'";
+                return false;
+            }
+            int t = G->lookup(right);
+            if (t < 0 || !G->isTerminal(t) || t == G->epsilon || t == G->endMarker) {
+                err = "line " + to_string(lineNo) + ": " + right + " is not a terminal";
+                return false;
+            }
+            int k = typeIndex(left);
+            if (k >= 0) byType[k] = t;
+            else byLexeme[left] = t;
+        }
+        return true;
+    }
+
+    // 记号对应的终结符编号，没有时为 -1
+    int map(int type, const string& lexeme) const {
+        if (type < 0 || type >= (int)byType.size()) return -1;
+        if (lexemeTypes[type]) {
+            auto it = byLexeme.find(lexeme);
+            if (it != byLexeme.end()) return it->second;
+        }
+        return byType[type];
+    }
+
+private:
+    const Grammar* G = nullptr;
+    vector<string> types;
+    vector<int> byType;                   // 种类 -> 终结符
+    vector<char> lexemeTypes;             // 该种类的记号是否先按词素映射
+    unordered_map<string, int> byLexeme;  // 词素 -> 终结符
+
+    int typeIndex(const string& name) const {
+        for (size_t k = 0; k < types.size(); ++k) {
+            if (types[k] == name) return (int)k;
+        }
+        return -1;
+    }
+};
@@ -0,0 +1,171 @@
+// 由终结符集合构造的最长匹配分词器（LL1Parser 与 LR1Parser 共用）
+//
+// 所有终结符（e 与 $ 除外）插入一棵字典树，转移表按“出现在终结符中的字节”压缩成稠密数组，
+// 每个结点占 K 个 int（K 为不同字节数）。分词时从当前位置沿树走到不能再走为止，
+// 取经过的最后一个终结结点（最长匹配）；没有终结符匹配时该字节记为未知记号 -1。
+// 每个记号至多回看最长终结符的长度，总时间对输入长度是线性的；分词过程不构造字符串。
+// skipSpace 为 true 时跳过记号之间的空白（终结符本身不含空白）。
+// TokenStream 在此之上经固定大小的缓冲区流式分词，内存与输入长度无关。
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "grammar.h"
+using namespace std;
+
+class Tokenizer {
+public:
+    bool skipSpace = true;
+
+    bool built() const { return !accept.empty(); }
+
+    void build(const Grammar& G) {
+        for (auto& c : classOf) c = -1;
+        K = 0;
+        maxLength = 1;
+        for (int t = 0; t < G.numTerminals; ++t) {
+            if (t == G.epsilon || t == G.endMarker) continue;
+            for (unsigned char c : G.names[t]) {
+                if (classOf[c] < 0) classOf[c] = K++;
+            }
+        }
+        next.assign(K, -1);
+        accept.assign(1, -1);
+        for (int t = 0; t < G.numTerminals; ++t) {
+            if (t == G.epsilon || t == G.endMarker) continue;
+            maxLength = max(maxLength, G.names[t].size());
+            int node = 0;
+            for (unsigned char c : G.names[t]) {
+                size_t e = (size_t)node * K + classOf[c];
+                if (next[e] < 0) {
+                    next[e] = (int)accept.size();
+                    accept.push_back(-1);
+                    next.resize(next.size() + K, -1);
+                }
+                node = next[e];
+            }
+            accept[node] = t;
+        }
+    }
+
+    // 把 input 分成终结符编号序列（不含 $）；spans 非空时记录每个记号在 input 中的 [起点, 终点)
+    vector<int> tokenize(const string& input, vector<pair<int, int>>* spans = nullptr) const {
+        vector<int> ids;
+        if (spans) spans->clear();
+        const unsigned char* s = (const unsigned char*)input.data();
+        size_t n = input.size(), i = 0;
+        while (i < n) {
+            if (skipSpace && isspace(s[i])) {
+                ++i;
+                continue;
+            }
+            size_t end;
+            ids.push_back(match(s, n, i, end));
+            if (spans) spans->emplace_back((int)i, (int)end);
+            i = end;
+        }
+        return ids;
+    }
+
+    // 从 s[i] 起最长匹配一个记号（s[i] 不是空白），返回终结符编号（-1 为未知）并把终点写入 end。
+    // more 非空时，若走到 n 时字典树仍可继续，置 *more 为 true：后面的字节可能构成更长的匹配
+    int match(const unsigned char* s, size_t n, size_t i, size_t& end, bool* more = nullptr) const {
+        int node = 0, best = -1;
+        end = i + 1;
+        size_t j = i;
+        for (; j < n; ++j) {
+            int c = classOf[s[j]];
+            if (c < 0 || (node = next[(size_t)node * K + c]) < 0) break;
+            if (accept[node] >= 0) {
+                best = accept[node];
+                end = j + 1;
+            }
+        }
+        if (more) *more = j == n;
+        return best;
+    }
+
+    // 最长终结符的字节数（至少为 1），即一次匹配至多看的字节数
+    size_t longest() const { return maxLength; }
+
+private:
+    int classOf[256];           // 字节 -> 压缩后的字母编号，-1 表示不出现在任何终结符中
+    int K = 0;                  // 字母数
+    vector<int> next;           // next[node * K + c]：字典树转移，-1 表示无
+    vector<int> accept;         // accept[node]：结点对应的终结符，-1 表示不是终结结点
+    size_t maxLength = 1;
+};
+
+// 流式分词：经固定大小的缓冲区从 in 读入，每次取出一个记号，取出的字节随即丢弃。
+// 缓冲区剩余的字节不够判断最长匹配时，把未用的部分移到开头再读，所以缓冲区只需大于最长终结符。
+// 输入结束后 next() 一直返回 endMarker；line() 与 offset() 为最近取出的记号的位置，用于报错
+class TokenStream {
+public:
+    TokenStream(const Tokenizer& lexer, istream& in, int endMarker, size_t bufferSize = 1 << 16)
+        : lexer(lexer), in(in), endMarker(endMarker), buf(max(bufferSize, lexer.longest() + 1)) {}
+
+    int next() {
+        while (true) {
+            while (begin < end && isspace(buf[begin])) {
+                if (buf[begin] == '\n') ++lines;
+                ++begin;
+            }
+            if (begin == end) {
+                if (eof) {
+                    tokenLine = lines;
+                    tokenOffset = base + begin;
+                    return endMarker;
+                }
+                refill();
+                continue;
+            }
+            bool more = false;
+            size_t stop;
+            int id = lexer.match(buf.data(), end, begin, stop, &more);
+            if (more && !eof) {
+                refill();
+                continue;
+            }
+            tokenLine = lines;
+            tokenOffset = base + begin;
+            begin = stop;
+            ++tokens;
+            return id;
+        }
+    }
+
+    uint64_t line() const { return tokenLine; }     // 从 1 开始
+    uint64_t offset() const { return tokenOffset; } // 字节偏移
+    uint64_t count() const { return tokens; }       // 已取出的记号数（不含 endMarker）
+    uint64_t bytes() const { return base + end; }   // 已读入的字节数
+
+private:
+    const Tokenizer& lexer;
+    istream& in;
+    int endMarker;
+    vector<unsigned char> buf;
+    size_t begin = 0, end = 0;  // 缓冲区中未用的字节 [begin, end)
+    uint64_t base = 0;          // buf[0] 在输入中的偏移
+    uint64_t lines = 1, tokenLine = 1, tokenOffset = 0, tokens = 0;
+    bool eof = false;
+
+    // 丢弃已用的字节并读入更多；读不到时置 eof
+    void refill() {
+        if (begin > 0) {
+            memmove(buf.data(), buf.data() + begin, end - begin);
+            base += begin;
+            end -= begin;
+            begin = 0;
+        }
+        in.read((char*)buf.data() + end, (streamsize)(buf.size() - end));
+        size_t n = (size_t)in.gcount();
+        end += n;
+        if (n == 0) eof = true;
+    }
+};
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include "probes.h"
 
 #define MAX_TOKEN_LENGTH 1024
 
@@ -18,6 +19,12 @@ typedef enum {
     TOKEN_TYPE_COUNT
 } TokenType;
 
+// 标记类型名，与 TokenType 一一对应
+const char* token_type_names[TOKEN_TYPE_COUNT] = {
+    "KEYWORD", "IDENTIFIER", "OPERATOR", "DELIMITER",
+    "CHARCON", "STRING", "NUMBER", "ERROR"
+};
+
 // 枚举定义字符类型
 typedef enum {
     CHAR_LETTER = 0,
@@ -46,9 +53,14 @@ typedef struct {
     char* lexeme;
     int lexeme_length;
     int lexeme_capacity;
+    // 记号回调：非空时 output_token 把记号交给它而不打印（供语法分析驱动程序使用）
+    void (*emit)(void* ctx, int line, TokenType type, const char* value, int length);
+    void* emit_ctx;
 } LexerState;
 
 // 函数声明
+void lexer_init(LexerState* state, FILE* file);
+void lexer_run(LexerState* state);
 int read_char(LexerState* state);
 void unread_char(LexerState* state, int ch);
 CharType classify_char(int ch);
@@ -66,6 +78,8 @@ void process_string_or_char(LexerState* state, const char* prefix);
 int is_valid_integer_suffix(const char* suffix);
 int is_valid_float_suffix(const char* suffix);
 
+// 定义 LEXER_NO_MAIN 后可把本文件包含进其他程序（如 pipeline.cpp），只使用词法分析部分
+#ifndef LEXER_NO_MAIN
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         fprintf(stderr, "用法: %s <源文件名>\n", argv[0]);
@@ -74,21 +88,54 @@ int main(int argc, char* argv[]) {
 
     // 初始化词法分析器状态
     LexerState state;
-    state.file = fopen(argv[1], "r");
-    if (!state.file) {
+    FILE* file = fopen(argv[1], "r");
+    if (!file) {
         perror("文件打开失败");
         return EXIT_FAILURE;
     }
-    state.line_number = 1;
-    memset(state.token_counts, 0, sizeof(state.token_counts));
-    state.lexeme_capacity = MAX_TOKEN_LENGTH;
-    state.lexeme = (char*)malloc(state.lexeme_capacity);
-    state.lexeme_length = 0;
+    lexer_init(&state, file);
+    lexer_run(&state);
+
+    fclose(state.file);
+
+    // 输出总行数
+    printf("%d\n", state.line_number);
+
+    // 输出各标记类型的计数
+    for (int i = 0; i < TOKEN_TYPE_COUNT - 1; ++i) {
+        printf("%lld", state.token_counts[i]);
+        if (i == NUMBER) {
+            putchar('\n');
+        }
+        else {
+            putchar(' ');
+        }
+    }
+    printf("%lld", state.token_counts[ERROR]); // 输出结束后不再输出换行符
+
+    free(state.lexeme);
+    return EXIT_SUCCESS;
+}
+#endif
+
+// 初始化词法分析器状态
+void lexer_init(LexerState* state, FILE* file) {
+    state->file = file;
+    state->line_number = 1;
+    memset(state->token_counts, 0, sizeof(state->token_counts));
+    state->lexeme_capacity = MAX_TOKEN_LENGTH;
+    state->lexeme = (char*)malloc(state->lexeme_capacity);
+    state->lexeme_length = 0;
+    state->emit = NULL;
+    state->emit_ctx = NULL;
+}
 
+// 扫描整个文件，每识别出一个记号调用一次 output_token
+void lexer_run(LexerState* state) {
     int ch;
-    while ((ch = read_char(&state)) != EOF) {
+    while ((ch = read_char(state)) != EOF) {
         if (ch == '\n') {
-            state.line_number++;
+            state->line_number++;
         }
         if (isspace(ch)) {
             continue;
@@ -97,42 +144,22 @@ int main(int argc, char* argv[]) {
         CharType char_type = classify_char(ch);
         switch (char_type) {
         case CHAR_LETTER:
-            process_word(&state, ch);
+            process_word(state, ch);
             break;
         case CHAR_DIGIT:
-            process_number(&state, ch);
+            process_number(state, ch);
             break;
         case CHAR_SINGLE_QUOTE:
-            process_char_const(&state, ch);
+            process_char_const(state, ch);
             break;
         case CHAR_DOUBLE_QUOTE:
-            process_string(&state);
+            process_string(state);
             break;
         case CHAR_OTHER:
-            process_operator_or_delimiter(&state, ch);
+            process_operator_or_delimiter(state, ch);
             break;
         }
     }
-
-    fclose(state.file);
-
-    // 输出总行数
-    printf("%d\n", state.line_number);
-
-    // 输出各标记类型的计数
-    for (int i = 0; i < TOKEN_TYPE_COUNT - 1; ++i) {
-        printf("%lld", state.token_counts[i]);
-        if (i == NUMBER) {
-            putchar('\n');
-        }
-        else {
-            putchar(' ');
-        }
-    }
-    printf("%lld", state.token_counts[ERROR]); // 输出结束后不再输出换行符
-
-    free(state.lexeme);
-    return EXIT_SUCCESS;
 }
 
 // 从文件读取下一个字符
@@ -184,11 +211,13 @@ void reset_lexeme(LexerState* state) {
 
 // 输出标记，按照 v0 的格式
 void output_token(LexerState* state, TokenType type, const char* value) {
-    const char* type_names[] = {
-        "KEYWORD", "IDENTIFIER", "OPERATOR", "DELIMITER",
-        "CHARCON", "STRING", "NUMBER", "ERROR"
-    };
-    printf("%d <%s,%s>\n", state->line_number, type_names[type], value);
+    PARSER_PROBE4(lexer, token, state->line_number, (int)type, value, state->lexeme_length);
+    if (state->emit) {
+        state->emit(state->emit_ctx, state->line_number, type, value, (int)strlen(value));
+    }
+    else {
+        printf("%d <%s,%s>\n", state->line_number, token_type_names[type], value);
+    }
     state->token_counts[type]++;
     reset_lexeme(state);
 }
@@ -254,6 +283,7 @@ void process_word(LexerState* state, int ch) {
 
 // 处理带前缀的字符串或字符常量
 void process_string_or_char(LexerState* state, const char* prefix) {
+    (void)prefix; // 前缀已在 lexeme 中
     int ch = state->lexeme[state->lexeme_length - 1]; // 已经读取了引号
     int is_string = (ch == '"');
     int is_valid = 1;